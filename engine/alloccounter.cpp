@@ -0,0 +1,45 @@
+#include "alloccounter.h"
+#include <cstdlib>
+#include <new>
+
+/// Alocações feitas por cada thread
+static thread_local size_t allocations = 0;
+
+size_t threadAllocationCount() {
+    return allocations;
+}
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size > 0 ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    allocations++;
+    size_t align = (size_t)alignment;
+    void* p = aligned_alloc(align, (size + align - 1) / align * align);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    free(p);
+}
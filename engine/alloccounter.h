@@ -0,0 +1,11 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @brief Número de alocações (operator new) feitas pela thread atual.
+ *
+ * O operator new global é substituído por uma versão que incrementa um
+ * contador por thread, pelo que a diferença entre duas leituras na mesma
+ * thread conta só as alocações desse troço de código.
+ */
+size_t threadAllocationCount();
@@ -157,13 +157,15 @@ void Camera::zoomOut() {
 
 // ==================== Renderização ====================
 
-void Camera::place() {
-    // Aplica a transformação de câmera usando a função gluLookAt do OpenGL
-    // Esta função define a matriz de visualização (view matrix) com base em:
+mat4 Camera::viewMatrix() const {
+    // Matriz de visualização (view matrix) calculada a partir de:
     // - Posição da câmera (posX, posY, posZ)
     // - Ponto para o qual está olhando (lookAtX, lookAtY, lookAtZ)
     // - Vetor "para cima" (upX, upY, upZ)
-    gluLookAt(posX, posY, posZ,
-              lookAtX, lookAtY, lookAtZ,
-              upX, upY, upZ);
+    return mat4::lookAt(vec3{posX, posY, posZ}, vec3{lookAtX, lookAtY, lookAtZ}, vec3{upX, upY, upZ});
+}
+
+void Camera::place() {
+    // Aplica a matriz de visualização, calculada no CPU, à matriz atual
+    glMultMatrixf(viewMatrix().m);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include "mathlib.h"
 
 /**
  * @class Camera
@@ -200,11 +201,16 @@ public:
     void zoomOut();
     
     
+    /**
+     * @brief Matriz de visualização (a mesma de gluLookAt) com a posição, o lookAt e o vetor up atuais.
+     */
+    mat4 viewMatrix() const;
+    
     /**
      * @brief Aplica a transformação da câmera no contexto OpenGL.
      *
      * Deve ser chamada uma vez por frame, antes de desenhar os objetos da cena.
-     * Utiliza gluLookAt() para posicionar a câmera com base em seus parâmetros atuais.
+     * Multiplica a matriz atual por viewMatrix().
      */
     void place();
 };
\ No newline at end of file
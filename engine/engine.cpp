@@ -3,12 +3,33 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <cstring>
 #include <math.h>
 #include <GL/glut.h>
 #include "tinyxml2.h"
 #include "camera.h"
 #include "parser.h"
+#include "../generator/figures.h"
+#include "../generator/optimizer.h"
+#include "../generator/quantize.h"
+#include "../generator/terrain.h"
+#include "modelcache.h"
 #include <map>
+#include <memory_resource>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "loadqueue.h"
+#include "filewatch.h"
+#include "scenepack.h"
+#include "alloccounter.h"
+#include "staticbatch.h"
+#include "mathlib.h"
+#include "jobpool.h"
+#include <set>
+#include <algorithm>
 
 using namespace std;
 using namespace tinyxml2;
@@ -44,16 +65,156 @@ struct Face {
  * - Lista de vértices (coordenadas 3D)
  * - Lista de faces (triângulos definidos por índices de vértices)
  * - Informação se o modelo foi carregado com sucesso
+ * - AABB, desenhada como caixa provisória enquanto o modelo carrega
  */
 struct ModelData {
     string filename;              ///< Caminho do arquivo de origem
     vector<Vertex> vertices;      ///< Lista de vértices do modelo
     vector<Face> faces;           ///< Lista de faces (triângulos)
     bool loaded;                  ///< Flag indicando se foi carregado com sucesso
+    bool pending;                 ///< Flag indicando que o modelo ainda está a ser carregado
+    float bounds[6];              ///< AABB: mínimo x, y, z seguido do máximo x, y, z
+    unsigned int version;         ///< Carregamento em curso; resultados de outra versão são descartados
     
-    ModelData() : loaded(false) {}
+    ModelData() : loaded(false), pending(false), bounds{0, 0, 0, 0, 0, 0}, version(0) {}
 };
 
+/**
+ * @struct LoadJob
+ * @brief Modelo a carregar por uma thread de carregamento.
+ */
+struct LoadJob {
+    Model model;                  ///< Modelo lido do XML
+    uint32_t asset;               ///< Índice da geometria em Scene::assets
+    int chunk;                    ///< Índice do bloco de terreno 3DC1, ou -1
+    ChunkInfo chunkInfo;          ///< Entrada da tabela de blocos (se chunk >= 0)
+    size_t slot;                  ///< Índice do modelo em modelDataList
+    unsigned int version;         ///< Versão do modelo quando o trabalho foi criado
+    
+    LoadJob() : asset(NO_INDEX), chunk(-1), chunkInfo(), slot(0), version(0) {}
+};
+
+/**
+ * @struct LoadBatch
+ * @brief Conjunto de trabalhos partilhado pelas threads de carregamento.
+ */
+struct LoadBatch {
+    vector<LoadJob> jobs;         ///< Trabalhos a fazer
+    atomic<size_t> next;          ///< Próximo trabalho a atribuir a uma thread
+    atomic<unsigned int> active;  ///< Threads do conjunto que ainda não terminaram
+    vector<thread> threads;       ///< Threads do conjunto (só a thread de renderização lhes acede)
+    
+    LoadBatch() : next(0), active(0) {}
+};
+
+/**
+ * @struct LoadResult
+ * @brief Modelo carregado, entregue à thread de renderização pela fila sem locks.
+ */
+struct LoadResult {
+    size_t slot;                  ///< Índice em modelDataList
+    unsigned int version;         ///< Versão do trabalho que o carregou
+    unique_ptr<ModelData> data;   ///< Modelo carregado, ou nulo se falhou
+};
+
+/**
+ * @struct DrawCommand
+ * @brief Modelo a desenhar com a matriz de um nó de FramePlan.
+ */
+struct DrawCommand {
+    uint32_t node;                ///< Nó de FramePlan, cuja matriz é carregada
+    uint32_t slot;                ///< Índice em modelDataList
+    uint32_t model;               ///< Índice em Scene::models, para a cor
+};
+
+/**
+ * @struct FramePartition
+ * @brief Intervalo de nós de FramePlan atualizado por um único trabalho.
+ *
+ * As raízes do intervalo têm todas o mesmo pai, que é atualizado antes.
+ */
+struct FramePartition {
+    uint32_t begin, end;          ///< Nós [begin, end)
+    uint32_t parent;              ///< Pai das raízes, ou UINT32_MAX (matriz de visualização)
+    uint32_t firstItem, endItem;  ///< Modelos dos nós, em FramePlan::items
+};
+
+/**
+ * @struct FramePlan
+ * @brief Hierarquia da cena achatada em nós e partida em trabalhos independentes.
+ *
+ * Cada <use> repete os nós do protótipo. É reconstruído quando a cena ou os
+ * lotes estáticos mudam; entre frames só mudam as matrizes dos grupos temporizados.
+ */
+struct FramePlan {
+    vector<uint32_t> groups;      ///< Grupo da cena de cada nó, em pré-ordem
+    vector<uint32_t> parents;     ///< Pai de cada nó relativo ao início da partição, ou UINT32_MAX nas raízes
+    vector<mat4> locals;          ///< Produto das transformações de cada nó
+    vector<DrawCommand> items;    ///< Modelos a desenhar, pela ordem dos nós
+    vector<FramePartition> partitions; ///< Primeiro os nós de cabeça, depois as subárvores
+    size_t headCount = 0;         ///< Partições de cabeça: um nó cada, atualizadas por ordem antes das outras
+    bool animated = false;        ///< Algum nó tem transformações temporizadas
+    bool valid = false;
+};
+
+/**
+ * @struct FrameData
+ * @brief Dados e resultado da atualização de um frame, consumido pela thread de renderização.
+ *
+ * Há dois: enquanto um é desenhado, o outro é preenchido em segundo plano
+ * com o frame seguinte.
+ */
+struct FrameData {
+    float time = 0;               ///< Tempo do frame (s), previsto se preparado em segundo plano
+    mat4 view;                    ///< Matriz de visualização
+    mat4 projection;              ///< Matriz de projeção, para a seleção dos modelos visíveis
+    uint64_t revision = 0;        ///< frameRevision quando a atualização começou
+    bool ready = false;           ///< Atualização terminada e ainda não desenhada
+    vector<mat4> worlds;          ///< Matriz modelview de cada nó
+    vector<vector<DrawCommand>> runs;  ///< Comandos visíveis de cada partição, ordenados
+    vector<DrawCommand> draws;    ///< Lista de desenho final, ordenada por modelo
+    vector<DrawCommand> scratch;  ///< Memória da fusão das listas
+    vector<size_t> runStarts;     ///< Início de cada lista ordenada durante a fusão
+};
+
+/**
+ * @struct WeldKey
+ * @brief Chave de um vértice no mapa de deduplicação de loadModel.
+ *
+ * Cada coordenada é arredondada a 6 casas decimais, como fazia a chave
+ * to_string(x) + "," + ... usada antes, mas sem alocar uma string por vértice.
+ * Tal como em to_string, -0.000000 e 0.000000 são chaves diferentes.
+ */
+struct WeldKey {
+    long long x, y, z;
+    
+    WeldKey(float _x, float _y, float _z) : x(quantize(_x)), y(quantize(_y)), z(quantize(_z)) {}
+    
+    bool operator==(const WeldKey& other) const { return x == other.x && y == other.y && z == other.z; }
+    
+    static long long quantize(float value) {
+        long long scaled = llround((double)value * 1e6);
+        return scaled * 2 + (scaled == 0 && signbit(value) ? 1 : 0);
+    }
+};
+
+/**
+ * @struct WeldKeyHash
+ * @brief Hash de WeldKey para unordered_map.
+ */
+struct WeldKeyHash {
+    size_t operator()(const WeldKey& key) const {
+        uint64_t h = (uint64_t)key.x * 0x9E3779B97F4A7C15ULL;
+        h ^= (uint64_t)key.y * 0xC2B2AE3D27D4EB4FULL + (h << 6) + (h >> 2);
+        h ^= (uint64_t)key.z * 0x165667B19E3779F9ULL + (h << 6) + (h >> 2);
+        return (size_t)(h ^ (h >> 29));
+    }
+};
+
+// A cache de modelos copia os vértices e as faces diretamente do mapeamento
+static_assert(sizeof(Vertex) == 3 * sizeof(float), "Vertex tem de ser 3 floats contíguos");
+static_assert(sizeof(Face) == 3 * sizeof(uint32_t), "Face tem de ser 3 índices de 32 bits");
+
 
 Window window;                              ///< Dimensões da janela de visualização
 Camera* camera;                             ///< Ponteiro para a câmera da cena
@@ -61,6 +222,75 @@ vector<ModelData> modelDataList;            ///< Lista de todos os modelos carre
 
 bool showAxes = false;                      ///< Flag para mostrar/esconder eixos coordenados
 bool wireframeMode = false;                 ///< Flag para ativar/desativar modo wireframe
+bool optimizeModels = false;                ///< Flag para otimizar os modelos ao carregar (--optimize)
+bool useModelCache = true;                  ///< Flag para usar a cache de modelos (--no-cache desativa)
+string modelCacheDir = "cache3d";           ///< Pasta da cache de modelos (--cache-dir)
+
+/// Tamanho dos blocos das pools de elementos e atributos do documento XML de loadModel
+const int MODEL_POOL_BLOCK_BYTES = 64 * 1024;
+/// Modelos maiores do que isto libertam a memória do documento XML depois do parse
+const size_t MODEL_DOCUMENT_RETAIN_BYTES = 32 * 1024 * 1024;
+/// Modelos maiores do que isto são lidos aos blocos (XMLPullParser), sem documento XML
+const size_t MODEL_STREAM_BYTES = 256 * 1024 * 1024;
+/// Primeiro bloco (na pilha) da arena de memória temporária de loadModel
+const size_t LOAD_ARENA_STACK_BYTES = 64 * 1024;
+/// Tempo máximo por frame a publicar modelos carregados (ms)
+const double UPLOAD_BUDGET_MS = 4.0;
+/// Número máximo de threads de carregamento
+const unsigned int MAX_LOADER_THREADS = 8;
+/// Máximo de divisões, fatias ou camadas de uma figura procedural
+const int MAX_PROCEDURAL_DIVISIONS = 4096;
+/// Máximo de subdivisões de uma icosfera (20 * 4^8 triângulos)
+const int MAX_ICOSPHERE_SUBDIVISIONS = 8;
+
+/// Intervalo entre verificações de ficheiros alterados (ms)
+const int WATCH_INTERVAL_MS = 250;
+/// Tempo mínimo de parse repetido de cada ficheiro em --bench-parse (s)
+const double BENCH_PARSE_SECONDS = 0.5;
+/// Intervalo entre frames de cenas com transformações temporizadas (ms)
+const int ANIMATION_INTERVAL_MS = 16;
+/// Máximo de vértices nos lotes estáticos; acima disto a cena é desenhada sem lotes
+const size_t STATIC_BATCH_MAX_VERTICES = 16 * 1024 * 1024;
+/// Número máximo de threads de atualização do frame, incluindo a de renderização
+const unsigned int MAX_FRAME_THREADS = 16;
+/// Nós mínimos por trabalho de atualização do frame; abaixo disto não compensa dividir
+const size_t FRAME_NODES_PER_JOB = 256;
+/// Diferença máxima entre o tempo previsto de um frame preparado e o real, em fração do intervalo entre frames
+const float FRAME_PREDICTION_TOLERANCE = 0.5f;
+/// Intervalo máximo usado para prever o tempo do frame seguinte (s), para não extrapolar após uma pausa
+const float MAX_PREDICTED_INTERVAL = 0.1f;
+/// groupAnimation: o grupo tem transformações temporizadas
+const uint8_t ANIMATED_GROUP = 1;
+/// groupAnimation: o grupo ou algum descendente (incluindo os <use>) tem transformações temporizadas
+const uint8_t ANIMATED_SUBTREE = 2;
+
+string sceneFile;                           ///< Ficheiro XML da cena
+Scene scene;                                ///< Hierarquia da cena, tal como lida do XML ou do pacote
+vector<LoadJob> sceneJobs;                  ///< Trabalho que descreve cada modelo (paralelo a modelDataList)
+vector<size_t> assetSlots;                  ///< Primeira entrada de modelDataList de cada geometria da cena, e o total no fim
+bool animationTimerActive = false;          ///< Flag indicando que animationTimer está agendado
+vector<uint8_t> groupAnimation;             ///< ANIMATED_GROUP e ANIMATED_SUBTREE de cada grupo da cena
+vector<StaticBatch> staticBatches;          ///< Modelos estáticos, já transformados, juntos por material
+bool staticBatchesTried = false;            ///< Flag indicando que os lotes já foram construídos (ou recusados) para a cena atual
+bool staticBatchesReady = false;            ///< Flag indicando que os modelos estáticos são desenhados pelos lotes
+unsigned int nextVersion = 1;               ///< Próxima versão a atribuir a um carregamento
+LoadQueue<LoadResult> loadedModels;         ///< Modelos carregados à espera de publicação
+vector<shared_ptr<LoadBatch>> loadBatches;  ///< Conjuntos com threads de carregamento por juntar
+atomic<bool> loadersStopping(false);        ///< Flag para as threads de carregamento pararem no fim do trabalho atual
+size_t pendingModels = 0;                   ///< Modelos ainda não publicados (thread de renderização)
+bool loadingTimerActive = false;            ///< Flag indicando que loadingTimer está agendado
+bool watchFiles = false;                    ///< Flag para recarregar ficheiros alterados (--watch)
+bool countAllocations = false;              ///< Flag para mostrar as alocações de cada carregamento (--count-allocs)
+FileWatcher* watcher = nullptr;             ///< Observador da cena e dos modelos (com --watch)
+bool frustumCulling = true;                 ///< Flag para não desenhar modelos fora da vista (--no-cull desativa)
+mat4 projection = mat4::identity();         ///< Matriz de projeção atual
+JobPool* frameJobs = nullptr;               ///< Threads de atualização do frame
+AsyncTask* frameUpdater = nullptr;          ///< Prepara o frame seguinte enquanto o atual é desenhado
+FramePlan framePlan;                        ///< Nós e partições da cena atual
+FrameData frames[2];                        ///< Frame a desenhar e frame seguinte
+size_t currentFrame = 0;                    ///< Índice em frames do próximo frame a desenhar
+uint64_t frameRevision = 0;                 ///< Muda quando os modelos publicados, a cena ou os lotes mudam
+float lastFrameTime = -1;                   ///< Tempo do último frame desenhado (s), para prever o seguinte
 
 
 /**
@@ -73,6 +303,273 @@ bool wireframeMode = false;                 ///< Flag para ativar/desativar modo
  */
 bool loadModel(ModelData& modelData, const string& filename);
 
+/**
+ * @brief Copia uma malha gerada (Mesh) para a estrutura ModelData.
+ *
+ * @param mesh Malha indexada de origem
+ * @param modelData Estrutura de destino (vértices e faces são substituídos)
+ */
+void copyMesh(const Mesh& mesh, ModelData& modelData);
+
+/**
+ * @brief Gera um modelo procedural em memória, sem passar pelo disco.
+ *
+ * @param modelData Referência para struct que será preenchida com os dados
+ * @param model Modelo com a figura e os parâmetros lidos do XML
+ *
+ * @return true se a figura é conhecida, false caso contrário
+ */
+bool loadProceduralModel(ModelData& modelData, const Model& model);
+
+/**
+ * @brief Carrega um modelo, um modelo procedural ou um bloco de terreno.
+ *
+ * @param job Trabalho de carregamento
+ * @param modelData Referência para struct que será preenchida com os dados
+ *
+ * @return true se carregado com sucesso, false caso contrário
+ */
+bool loadJobModel(const LoadJob& job, ModelData& modelData);
+
+/**
+ * @brief Descrição para o carregamento (ficheiro ou figura e parâmetros) de um modelo da cena.
+ */
+Model sceneModelToModel(const Scene& scene, const SceneModel& sceneModel);
+
+/**
+ * @brief Cria um trabalho por geometria da cena, ou por bloco no caso de terrenos 3DC1.
+ *
+ * Os trabalhos seguem a ordem de Scene::assets: cada ficheiro ou figura é
+ * carregado uma única vez, seja qual for o número de modelos que o usam. Os
+ * campos slot e version ficam por preencher.
+ */
+vector<LoadJob> expandModels(const Scene& scene);
+
+/**
+ * @brief Preenche assetSlots a partir de sceneJobs.
+ */
+void mapAssetSlots();
+
+/**
+ * @brief Cria a entrada provisória (caixa) de modelDataList de um trabalho.
+ */
+ModelData makePlaceholder(const LoadJob& job);
+
+/**
+ * @brief Chave que identifica o modelo de um trabalho ao comparar duas versões da cena.
+ */
+string jobKey(const LoadJob& job);
+
+/**
+ * @brief Inicia threads de carregamento para um conjunto de trabalhos.
+ */
+void startLoading(const vector<LoadJob>& jobs);
+
+/**
+ * @brief Pede às threads de carregamento que parem e espera por elas.
+ *
+ * Cada thread termina o modelo em curso. Registada com atexit, para que
+ * nenhuma thread use loadedModels ou a cache depois dos destrutores estáticos.
+ */
+void stopLoading();
+/**
+ * @brief Estima a AABB de um modelo antes de o carregar.
+ *
+ * Usa o cabeçalho de ficheiros quantizados, a entrada da cache de modelos
+ * ou os parâmetros de modelos procedurais; caso contrário, um cubo unitário.
+ */
+void placeholderBounds(const Model& model, float bounds[6]);
+
+/**
+ * @brief Calcula a AABB dos vértices de um modelo.
+ */
+void computeBounds(ModelData& modelData);
+
+/**
+ * @brief Corpo das threads de carregamento.
+ *
+ * Cada thread retira trabalhos do conjunto até se esgotarem e entrega os
+ * modelos carregados na fila loadedModels.
+ */
+void loaderThread(shared_ptr<LoadBatch> batch);
+
+/**
+ * @brief Publica em modelDataList os modelos carregados, até UPLOAD_BUDGET_MS por frame.
+ *
+ * Chamada pela thread de renderização no início de cada frame.
+ */
+void publishLoadedModels();
+
+/**
+ * @brief Callback GLUT (temporizador) que pede frames enquanto há modelos a carregar.
+ */
+void loadingTimer(int value);
+
+/**
+ * @brief Agenda loadingTimer se ainda não estiver agendado.
+ */
+void ensureLoadingTimer();
+
+/**
+ * @brief Callback GLUT (temporizador) que pede frames enquanto a cena for animada.
+ */
+void animationTimer(int value);
+
+/**
+ * @brief Agenda animationTimer se a cena for animada e ainda não estiver agendado.
+ */
+void ensureAnimationTimer();
+
+/**
+ * @brief Recarrega a cena e os modelos alterados, mantendo a câmera.
+ *
+ * Se o XML mudou, é lido de novo e comparado com a cena atual: os modelos
+ * que se mantêm não são recarregados. Os modelos cujo ficheiro mudou são
+ * recarregados em segundo plano.
+ *
+ * @param changed Ficheiros alterados (cena e/ou modelos)
+ */
+void reloadScene(const set<string>& changed);
+
+/**
+ * @brief Ficheiros a observar: a cena e os ficheiros de todos os modelos.
+ */
+vector<string> watchedFiles();
+
+/**
+ * @brief Callback GLUT (temporizador) que verifica se algum ficheiro observado mudou.
+ */
+void watchTimer(int value);
+
+/**
+ * @brief Desenha em linhas a AABB de um modelo ainda a carregar.
+ */
+void drawBoundingBox(const float bounds[6]);
+
+/**
+ * @brief Desenha um modelo (ou a sua caixa provisória) com a matriz atual.
+ *
+ * @param modelData Modelo carregado
+ * @param sceneModel Modelo da cena, para a cor
+ */
+void drawModel(const ModelData& modelData, const SceneModel* sceneModel);
+
+/**
+ * @brief Percorre a hierarquia da cena em pré-ordem, com as subárvores dos <use> expandidas.
+ *
+ * @param enter Chamada com o índice de cada grupo ao entrar nele; devolve
+ *              false para não percorrer os descendentes
+ * @param leave Chamada ao sair de cada grupo em que enter devolveu true
+ */
+template <typename Enter, typename Leave>
+void walkGroups(Enter enter, Leave leave);
+
+/**
+ * @brief Desenha a hierarquia da cena, com as transformações de cada grupo.
+ *
+ * Com os lotes estáticos prontos, só desenha os modelos com alguma
+ * transformação temporizada no caminho, e só percorre as subárvores que os têm.
+ *
+ * @param time Tempo desde o início (s)
+ */
+void drawGroups(float time);
+
+/**
+ * @brief Constrói framePlan a partir da cena e do estado dos lotes estáticos.
+ */
+void buildFramePlan();
+
+/**
+ * @brief Calcula as matrizes e a lista de desenho de um frame nas threads de frameJobs.
+ *
+ * Não faz chamadas OpenGL nem lê a câmera: usa frame.time, frame.view e
+ * frame.projection, preenchidos pela thread de renderização. Pode correr em
+ * frameUpdater enquanto a thread de renderização desenha o frame anterior.
+ *
+ * @param frame Dados e resultado
+ */
+void updateFrame(FrameData& frame);
+
+/**
+ * @brief Espera pela preparação do frame seguinte, se estiver em curso.
+ *
+ * Tem de ser chamada antes de alterar a cena, modelDataList, os lotes
+ * estáticos ou framePlan.
+ */
+void waitFrameUpdate();
+
+/**
+ * @brief Anima, propaga as matrizes e seleciona os modelos visíveis de uma partição.
+ *
+ * @param p Índice em FramePlan::partitions
+ * @param time Tempo desde o início (s)
+ * @param frustum Volume de visualização no espaço da câmera
+ * @param frame Resultado (só as matrizes dos nós da partição e frame.runs[p])
+ */
+void updatePartition(size_t p, float time, const Frustum& frustum, FrameData& frame);
+
+/**
+ * @brief Desenha a lista de desenho de um frame (só a thread de renderização).
+ */
+void submitFrame(const FrameData& frame);
+
+/**
+ * @brief Preenche groupAnimation a partir da cena atual.
+ */
+void markAnimatedGroups();
+
+/**
+ * @brief Junta os modelos estáticos carregados em staticBatches.
+ *
+ * Estáticos são os modelos sem transformações temporizadas em nenhum grupo
+ * do caminho desde <world>; num pacote, todos os modelos.
+ */
+void buildSceneBatches();
+
+/**
+ * @brief Descarta os lotes estáticos (a cena ou os modelos mudaram).
+ */
+void resetStaticBatches();
+
+/**
+ * @brief Desenha cada lote estático com uma única chamada.
+ */
+void drawStaticBatches();
+
+/**
+ * @brief Reordena faces e vértices de um modelo para a cache de vértices da GPU.
+ *
+ * @param modelData Modelo a otimizar
+ */
+void optimizeModel(ModelData& modelData);
+
+/**
+ * @brief Compila uma cena XML num pacote (engine --pack cena.xml saida.pack).
+ *
+ * Carrega todos os modelos (cada ficheiro ou figura uma única vez) e escreve
+ * a janela, a câmera, a hierarquia da cena e as malhas com writeScenePack().
+ *
+ * @return true se o pacote foi escrito
+ */
+bool buildScenePack(const string& scenePath, const string& packPath);
+
+/**
+ * @brief Preenche a janela, a câmera, a cena e modelDataList (uma entrada por malha) a partir de um pacote.
+ *
+ * @return true se o pacote é válido
+ */
+bool loadScenePack(const string& packPath);
+
+/**
+ * @brief Mede o débito do parse XML de cada ficheiro (engine --bench-parse ficheiros...).
+ *
+ * Cada ficheiro é analisado repetidamente durante pelo menos BENCH_PARSE_SECONDS,
+ * primeiro com os scanners de byte a byte e depois com os vetorizados.
+ *
+ * @return 0 se todos os ficheiros foram analisados sem erros
+ */
+int benchParse(const vector<string>& files);
+
 /**
  * @brief Callback GLUT para redimensionamento da janela.
  *
@@ -124,45 +621,94 @@ void processSpecialKeys(int key, int xx, int yy);
 
 int main(int argc, char** argv) {
     // Valida argumentos de entrada
-    if (argc < 2) {
-        cerr << "Uso: " << argv[0] << " <arquivo_config.xml>" << endl;
+    string mode = argc >= 2 ? argv[1] : "";
+    if (argc < 2 || (mode == "--pack" && argc < 4) || (mode == "--load-pack" && argc < 3) ||
+        (mode == "--bench-parse" && argc < 3)) {
+        cerr << "Uso: " << argv[0] << " <arquivo_config.xml> [--optimize] [--no-cache] [--cache-dir pasta] [--watch] [--count-allocs] [--no-cull]" << endl;
+        cerr << "     " << argv[0] << " --pack <arquivo_config.xml> <pacote> [--optimize]" << endl;
+        cerr << "     " << argv[0] << " --load-pack <pacote>" << endl;
+        cerr << "     " << argv[0] << " --bench-parse <ficheiro.xml|ficheiro.3d>..." << endl;
         cerr << "Exemplo: " << argv[0] << " config.xml" << endl;
         return 1;
     }
     
-    // Cria câmera com valores padrão
-    camera = new Camera();
-    
-    // Estrutura para armazenar modelos a carregar
-    Group group;
-    
-    // Realiza o parse do arquivo XML de configuração
-    // O arquivo é lido apenas uma vez na inicialização (conforme requerido na Fase 1)
-    cout << "\n=== Inicializando Engine 3D - Fase 1 ===" << endl;
-    cout << "Carregando configuração de: " << argv[1] << endl;
-    
-    if (!SimpleParser::parseXMLFile(argv[1], window, *camera, group)) {
-        cerr << "Erro: falha ao fazer parse do arquivo XML." << endl;
-        return 1;
+    // Medição do parse: não abre a janela
+    if (mode == "--bench-parse") {
+        return benchParse(vector<string>(argv + 2, argv + argc));
     }
     
-    // Carrega todos os modelos especificados no arquivo XML
-    cout << "\nCarregando modelos..." << endl;
-    for (const Model& model : group.models) {
-        ModelData modelData;
-        if (loadModel(modelData, model.filename)) {
-            modelDataList.push_back(modelData);
-        } else {
-            cerr << "Aviso: falha ao carregar modelo: " << model.filename << endl;
+    // Opções adicionais
+    int firstOption = mode == "--pack" ? 4 : mode == "--load-pack" ? 3 : 2;
+    for (int i = firstOption; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--optimize") {
+            optimizeModels = true;
+        } else if (option == "--no-cache") {
+            useModelCache = false;
+        } else if (option == "--cache-dir" && i + 1 < argc) {
+            modelCacheDir = argv[++i];
+        } else if (option == "--watch") {
+            watchFiles = true;
+        } else if (option == "--count-allocs") {
+            countAllocations = true;
+        } else if (option == "--no-cull") {
+            frustumCulling = false;
         }
     }
     
-    if (modelDataList.empty()) {
-        cerr << "Erro: nenhum modelo foi carregado com sucesso." << endl;
-        return 1;
+    // Compilação do pacote: não abre a janela
+    if (mode == "--pack") {
+        return buildScenePack(argv[2], argv[3]) ? 0 : 1;
     }
     
-    cout << "\nTotal de modelos carregados com sucesso: " << modelDataList.size() << endl;
+    // Cria câmera com valores padrão e as threads de atualização dos frames
+    camera = new Camera();
+    frameJobs = new JobPool(min(max(thread::hardware_concurrency(), 1u), MAX_FRAME_THREADS));
+    frameUpdater = new AsyncTask();
+    atexit(waitFrameUpdate);
+    atexit(stopLoading);
+    
+    cout << "\n=== Inicializando Engine 3D - Fase 1 ===" << endl;
+    
+    if (mode == "--load-pack") {
+        // Pacote de cena: sem parse XML nem abertura de ficheiros de modelos
+        cout << "Carregando pacote: " << argv[2] << endl;
+        if (!loadScenePack(argv[2])) {
+            return 1;
+        }
+    } else {
+        // Realiza o parse do arquivo XML de configuração
+        cout << "Carregando configuração de: " << argv[1] << endl;
+        
+        if (!SimpleParser::parseXMLFile(argv[1], window, *camera, scene)) {
+            cerr << "Erro: falha ao fazer parse do arquivo XML." << endl;
+            return 1;
+        }
+        
+        // Prepara um trabalho de carregamento e uma caixa provisória por modelo.
+        // Os modelos são carregados em segundo plano depois de a janela abrir.
+        sceneFile = argv[1];
+        sceneJobs = expandModels(scene);
+        for (size_t i = 0; i < sceneJobs.size(); i++) {
+            sceneJobs[i].slot = i;
+            sceneJobs[i].version = nextVersion++;
+            modelDataList.push_back(makePlaceholder(sceneJobs[i]));
+        }
+        mapAssetSlots();
+        markAnimatedGroups();
+        
+        if (modelDataList.empty()) {
+            cerr << "Aviso: a cena não tem modelos." << endl;
+        }
+        
+        pendingModels = sceneJobs.size();
+        startLoading(sceneJobs);
+        
+        if (watchFiles) {
+            watcher = new FileWatcher();
+            watcher->setFiles(watchedFiles());
+        }
+    }
     
         
     // Inicializa GLUT com argumentos da linha de comando
@@ -188,6 +734,11 @@ int main(int argc, char** argv) {
     glutReshapeFunc(changeSize);       // Redimensionamento da janela
     glutKeyboardFunc(processKeys);     // Teclado (ASCII)
     glutSpecialFunc(processSpecialKeys); // Teclas especiais (setas, etc)
+    ensureLoadingTimer();                // Redesenha enquanto há modelos a carregar
+    ensureAnimationTimer();              // Redesenha enquanto há transformações temporizadas
+    if (watcher && watcher->isAvailable()) {
+        glutTimerFunc(WATCH_INTERVAL_MS, watchTimer, 0); // Recarrega ficheiros alterados
+    }
     
     
     // Ativa teste de profundidade para renderização correta de objetos 3D
@@ -215,8 +766,9 @@ int main(int argc, char** argv) {
     glutMainLoop();
     
     
-    // Liberta a memória alocada para a câmera
+    // Liberta a memória alocada para a câmera e para o observador
     delete camera;
+    delete watcher;
     
     return 0;
 }
@@ -239,14 +791,20 @@ int main(int argc, char** argv) {
  *
  * A função realiza:
  * 1. Abertura e leitura do arquivo
- * 2. Parse XML dos vértices e faces
+ * 2. Parse XML dos vértices e faces (aos blocos, com XMLPullParser, nos
+ *    ficheiros maiores do que MODEL_STREAM_BYTES)
  * 3. Deduplicação de vértices para otimizar uso de memória
  * 4. Armazenamento em estrutura ModelData
+ *
+ * O resultado é guardado na cache de modelos (modelCacheDir); nas execuções
+ * seguintes, se o hash do ficheiro não mudou, os passos 2 e 3 são substituídos
+ * por uma cópia da entrada mapeada em memória.
  */
 bool loadModel(ModelData& modelData, const string& filename) {
-    // Tenta abrir o arquivo do modelo
-    ifstream file(filename);
-    if (!file.is_open()) {
+    // Tenta abrir (mapear) o arquivo do modelo. O mapeamento é uma cópia privada
+    // para o parse XML ser feito sobre ele, sem copiar o ficheiro
+    MappedFile file;
+    if (!file.open(filename, true)) {
         cerr << "Erro ao abrir arquivo do modelo: " << filename << endl;
         return false;
     }
@@ -258,95 +816,913 @@ bool loadModel(ModelData& modelData, const string& filename) {
     modelData.vertices.clear();
     modelData.faces.clear();
     
-    // Lê todo o conteúdo do arquivo em uma string
-    string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
-    file.close();
+    // Formato binário quantizado (generator --compress): descodifica diretamente
+    const unsigned char* bytes = file.data();
+    if (isQuantizedMesh(bytes, file.size())) {
+        Mesh mesh;
+        if (!decodeQuantizedMesh(bytes, file.size(), mesh)) {
+            cerr << "Erro ao descodificar modelo quantizado: " << filename << endl;
+            return false;
+        }
+        
+        copyMesh(mesh, modelData);
+        cout << "Modelo carregado: " << filename << " (" << modelData.vertices.size()
+             << " vértices, " << modelData.faces.size() << " faces, quantizado)" << endl;
+        return true;
+    }
     
     
-    // Parse do conteúdo XML usando TinyXML2
-    XMLDocument doc;
-    if (doc.Parse(content.c_str()) != XML_SUCCESS) {
-        cerr << "Erro ao fazer parse XML do arquivo: " << filename << endl;
-        return false;
+    // Cache de modelos: entrada válida se o hash e o tamanho do ficheiro coincidem
+    uint64_t contentHash = 0;
+    string cachePath;
+    if (useModelCache) {
+        contentHash = hashContent(bytes, file.size());
+        cachePath = modelCachePath(modelCacheDir, filename);
+        
+        CachedModel cached;
+        if (openModelCache(cachePath, contentHash, file.size(), cached)) {
+            modelData.vertices.resize(cached.vertexCount);
+            modelData.faces.resize(cached.indexCount / 3);
+            memcpy((void*)modelData.vertices.data(), cached.vertices, (size_t)cached.vertexCount * sizeof(Vertex));
+            memcpy((void*)modelData.faces.data(), cached.indices, (size_t)cached.indexCount * sizeof(uint32_t));
+            
+            modelData.loaded = true;
+            cout << "Modelo carregado: " << filename << " (" << modelData.vertices.size()
+                 << " vértices, " << modelData.faces.size() << " faces, cache)" << endl;
+            return true;
+        }
     }
     
-    // Obtém elemento raiz (deve ser um de: plane, box, sphere, cone)
-    XMLElement* rootElement = doc.RootElement();
-    if (!rootElement) {
-        cerr << "Nenhum elemento raiz encontrado no arquivo: " << filename << endl;
-        return false;
-    }
     
-        
+    // Memória temporária do carregamento: arena monotónica com um primeiro bloco
+    // na pilha, libertada de uma só vez no fim da função
+    unsigned char arenaBuffer[LOAD_ARENA_STACK_BYTES];
+    pmr::monotonic_buffer_resource arena(arenaBuffer, sizeof(arenaBuffer));
+    
     // Mapa para armazenar vértices já adicionados e seus índices
-    // Chave: string "x,y,z" | Valor: índice no array de vértices
+    // Chave: coordenadas arredondadas a 6 casas decimais | Valor: índice no array de vértices
     // Isto otimiza memória evitando vértices duplicados
-    map<string, int> vertexIndices;
+    pmr::unordered_map<WeldKey, int, WeldKeyHash> vertexIndices(&arena);
     int nextIndex = 0;
+    int faceCount = 0;
     
+    // Acrescenta uma face com os 3 vértices (x, y, z) dados
+    auto addTriangle = [&](const float corners[3][3]) {
+        // Índices dos vértices desta face
+        int vertexIndicesForTriangle[3];
+        for (int corner = 0; corner < 3; corner++) {
+            float x = corners[corner][0], y = corners[corner][1], z = corners[corner][2];
+            
+            // Novo vértice: adiciona ao array de vértices; caso contrário reutiliza o índice
+            auto inserted = vertexIndices.emplace(WeldKey(x, y, z), nextIndex);
+            if (inserted.second) {
+                modelData.vertices.push_back(Vertex(x, y, z));
+                nextIndex++;
+            }
+            vertexIndicesForTriangle[corner] = inserted.first->second;
+        }
         
-    // Processa todos os elementos <triangle> do documento
-    XMLElement* triangleElement = rootElement->FirstChildElement("triangle");
-    int faceCount = 0;
+        modelData.faces.push_back(Face(
+            vertexIndicesForTriangle[0],
+            vertexIndicesForTriangle[1],
+            vertexIndicesForTriangle[2]
+        ));
+        faceCount++;
+    };
     
-    while (triangleElement) {
-        // Obtém os 3 vértices do triângulo
-        XMLElement* vertex1 = triangleElement->FirstChildElement("vertex");
-        XMLElement* vertex2 = vertex1 ? vertex1->NextSiblingElement("vertex") : nullptr;
-        XMLElement* vertex3 = vertex2 ? vertex2->NextSiblingElement("vertex") : nullptr;
+    if (file.size() > MODEL_STREAM_BYTES) {
+        // Ficheiro muito grande: lido aos blocos com o parser de eventos, sem
+        // construir o documento, para a memória não crescer com o ficheiro
+        XMLPullParser parser;
+        if (parser.Open(filename.c_str()) != XML_SUCCESS) {
+            cerr << "Erro ao abrir arquivo do modelo: " << filename << endl;
+            return false;
+        }
         
-        // Valida se todos os 3 vértices existem
-        if (vertex1 && vertex2 && vertex3) {
-            // Array para armazenar índices dos vértices desta face
-            vector<int> vertexIndicesForTriangle;
+        // Tal como com o documento, só conta o primeiro elemento raiz
+        int rootCount = 0;
+        bool inTriangle = false;
+        float corners[3][3];
+        int cornerCount = 0;
+        
+        XMLPullParser::Event event;
+        while ((event = parser.Next()) != XMLPullParser::END_DOCUMENT) {
+            if (event == XMLPullParser::PARSE_ERROR) {
+                cerr << "Erro ao fazer parse XML do arquivo: " << filename
+                     << " (linha " << parser.ErrorLineNum() << ")" << endl;
+                return false;
+            }
             
-            // Processa cada um dos 3 vértices do triângulo
-            for (XMLElement* vertex : {vertex1, vertex2, vertex3}) {
-                // Extrai coordenadas com valores padrão 0
-                float x = 0, y = 0, z = 0;
-                vertex->QueryFloatAttribute("x", &x);
-                vertex->QueryFloatAttribute("y", &y);
-                vertex->QueryFloatAttribute("z", &z);
-                
-                // Cria chave única para este vértice (coordenadas como string)
-                string vertexKey = to_string(x) + "," + to_string(y) + "," + to_string(z);
-                
-                // Verifica se vértice já foi visto antes
-                if (vertexIndices.find(vertexKey) == vertexIndices.end()) {
-                    // Novo vértice: adiciona ao array de vértices
-                    modelData.vertices.push_back(Vertex(x, y, z));
-                    vertexIndices[vertexKey] = nextIndex;
-                    vertexIndicesForTriangle.push_back(nextIndex);
-                    nextIndex++;
+            if (event == XMLPullParser::START_ELEMENT) {
+                if (parser.Depth() == 1) {
+                    rootCount++;
+                } else if (parser.Depth() == 2 && rootCount == 1 && strcmp(parser.Name(), "triangle") == 0) {
+                    inTriangle = true;
+                    cornerCount = 0;
+                } else if (parser.Depth() == 3 && inTriangle && cornerCount < 3 &&
+                           strcmp(parser.Name(), "vertex") == 0) {
+                    // Coordenadas com valores padrão 0
+                    float* xyz = corners[cornerCount++];
+                    xyz[0] = xyz[1] = xyz[2] = 0;
+                    parser.QueryFloatAttributes({"x", "y", "z"}, xyz);
+                }
+            } else if (event == XMLPullParser::END_ELEMENT && parser.Depth() == 2 && inTriangle) {
+                inTriangle = false;
+                if (cornerCount == 3) {
+                    addTriangle(corners);
                 } else {
-                    // Existing vertex, reuse its index
-                    vertexIndicesForTriangle.push_back(vertexIndices[vertexKey]);
+                    cerr << "Triangle missing vertices in model file: " << filename << endl;
                 }
             }
-            
-            // Add the face if we have three valid vertices
-            if (vertexIndicesForTriangle.size() == 3) {
-                modelData.faces.push_back(Face(
-                    vertexIndicesForTriangle[0],
-                    vertexIndicesForTriangle[1],
-                    vertexIndicesForTriangle[2]
-                ));
-                faceCount++;
+        }
+        
+        if (rootCount == 0) {
+            cerr << "Nenhum elemento raiz encontrado no arquivo: " << filename << endl;
+            return false;
+        }
+    } else {
+        // Parse do conteúdo XML usando TinyXML2, com um documento reutilizado por
+        // thread: o buffer e os blocos das pools passam de um modelo para o seguinte
+        thread_local XMLDocument doc;
+        thread_local bool documentConfigured = false;
+        if (!documentConfigured) {
+            doc.SetReuseBuffers(true);
+            doc.SetPoolBlockSize(MODEL_POOL_BLOCK_BYTES, MODEL_POOL_BLOCK_BYTES);
+            documentConfigured = true;
+        }
+        
+        // No fim, esvazia o documento (mantendo a memória) ou, se o modelo for
+        // muito grande, liberta-a para não a reter até ao próximo carregamento
+        struct DocumentRelease {
+            XMLDocument& doc;
+            size_t size;
+            ~DocumentRelease() {
+                if (size > MODEL_DOCUMENT_RETAIN_BYTES) {
+                    doc.ReleaseMemory();
+                } else {
+                    doc.Clear();
+                }
             }
-        } else {
-            cerr << "Triangle missing vertices in model file: " << filename << endl;
+        } release{doc, file.size()};
+        
+        file.prefaultForWrite();
+        if (doc.ParseInPlace(file.writableData(), file.size()) != XML_SUCCESS) {
+            cerr << "Erro ao fazer parse XML do arquivo: " << filename << endl;
+            return false;
         }
         
-        triangleElement = triangleElement->NextSiblingElement("triangle");
+        // Obtém elemento raiz (deve ser um de: plane, box, sphere, cone)
+        XMLElement* rootElement = doc.RootElement();
+        if (!rootElement) {
+            cerr << "Nenhum elemento raiz encontrado no arquivo: " << filename << endl;
+            return false;
+        }
+        
+        // Conta os triângulos para reservar a memória de uma só vez
+        size_t triangleCount = 0;
+        for (XMLElement* t = rootElement->FirstChildElement("triangle"); t; t = t->NextSiblingElement("triangle")) {
+            triangleCount++;
+        }
+        modelData.faces.reserve(triangleCount);
+        modelData.vertices.reserve(triangleCount / 2 + 3);  // Malha fechada: V ~ F / 2
+        vertexIndices.reserve(triangleCount / 2 + 3);
+        
+        // Processa todos os elementos <triangle> do documento
+        for (XMLElement* triangleElement = rootElement->FirstChildElement("triangle"); triangleElement;
+             triangleElement = triangleElement->NextSiblingElement("triangle")) {
+            // Obtém os 3 vértices do triângulo
+            XMLElement* vertex1 = triangleElement->FirstChildElement("vertex");
+            XMLElement* vertex2 = vertex1 ? vertex1->NextSiblingElement("vertex") : nullptr;
+            XMLElement* vertex3 = vertex2 ? vertex2->NextSiblingElement("vertex") : nullptr;
+            
+            // Valida se todos os 3 vértices existem
+            if (vertex1 && vertex2 && vertex3) {
+                // Extrai coordenadas (uma só passagem pelos atributos) com valores padrão 0
+                float corners[3][3] = {};
+                vertex1->QueryFloatAttributes({"x", "y", "z"}, corners[0]);
+                vertex2->QueryFloatAttributes({"x", "y", "z"}, corners[1]);
+                vertex3->QueryFloatAttributes({"x", "y", "z"}, corners[2]);
+                addTriangle(corners);
+            } else {
+                cerr << "Triangle missing vertices in model file: " << filename << endl;
+            }
+        }
     }
     
     modelData.loaded = true;
     cout << "Modelo carregado: " << filename << " (" << modelData.vertices.size() 
          << " vértices, " << faceCount << " faces)" << endl;
     
+    if (useModelCache &&
+        !writeModelCache(cachePath, contentHash, file.size(),
+                         (const float*)modelData.vertices.data(), (uint32_t)modelData.vertices.size(),
+                         (const uint32_t*)modelData.faces.data(), (uint32_t)modelData.faces.size() * 3)) {
+        cerr << "Aviso: falha ao escrever a cache de " << filename << " em " << cachePath << endl;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Copia uma malha indexada (Mesh) para os vértices e faces de ModelData.
+ */
+void copyMesh(const Mesh& mesh, ModelData& modelData) {
+    modelData.vertices.clear();
+    modelData.faces.clear();
+    modelData.vertices.reserve(mesh.vertexCount());
+    modelData.faces.reserve(mesh.triangleCount());
+    
+    for (size_t i = 0; i < mesh.vertices.size(); i += 3) {
+        modelData.vertices.push_back(Vertex(mesh.vertices[i], mesh.vertices[i + 1], mesh.vertices[i + 2]));
+    }
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        modelData.faces.push_back(Face(mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2]));
+    }
+    
+    modelData.loaded = true;
+}
+
+/**
+ * @brief Gera um modelo com a biblioteca do gerador e copia a malha para ModelData.
+ *
+ * Os parâmetros em falta usam os valores padrão de cada figura.
+ */
+bool loadProceduralModel(ModelData& modelData, const Model& model) {
+    // Lê um parâmetro do XML ou devolve o valor padrão
+    auto param = [&model](const string& name, float fallback) {
+        auto it = model.params.find(name);
+        return it != model.params.end() ? it->second : fallback;
+    };
+    
+    // Contagens (divisões, fatias, camadas): inteiros de 1 a MAX_PROCEDURAL_DIVISIONS.
+    // Uma contagem inválida gerava um modelo sem faces sem qualquer aviso.
+    const string& figure = model.procedural;
+    bool validCounts = true;
+    auto count = [&](const string& name, float fallback, int maximum = MAX_PROCEDURAL_DIVISIONS) {
+        float value = param(name, fallback);
+        if (!(value >= 1 && value <= MAX_PROCEDURAL_DIVISIONS)) {
+            cerr << "Aviso: " << name << "=" << value << " inválido na figura " << figure
+                 << " (de 1 a " << MAX_PROCEDURAL_DIVISIONS << "), modelo ignorado" << endl;
+            validCounts = false;
+            return 1;
+        }
+        if (value > maximum) {
+            cerr << "Aviso: " << name << "=" << value << " na figura " << figure
+                 << " limitado a " << maximum << endl;
+            return maximum;
+        }
+        return (int)value;
+    };
+    
+    Mesh mesh;
+    if (figure == "plane") {
+        int divisions = count("divisions", 1);
+        mesh = buildPlane(param("length", 1), divisions);
+    } else if (figure == "box") {
+        int divisions = count("divisions", 1);
+        mesh = buildBox(param("size", 1), divisions);
+    } else if (figure == "sphere") {
+        int slices = count("slices", 16), stacks = count("stacks", 16);
+        mesh = buildSphere(param("radius", 1), slices, stacks);
+    } else if (figure == "cone") {
+        int slices = count("slices", 16), stacks = count("stacks", 4);
+        mesh = buildCone(param("radius", 1), param("height", 2), slices, stacks);
+    } else if (figure == "icosphere") {
+        int subdivisions = count("subdivisions", 2, MAX_ICOSPHERE_SUBDIVISIONS);
+        mesh = buildIcosphere(param("radius", 1), subdivisions);
+    } else {
+        cerr << "Figura procedural desconhecida: " << figure << endl;
+        return false;
+    }
+    if (!validCounts) {
+        return false;
+    }
+    
+    modelData.filename = figure;
+    copyMesh(mesh, modelData);
+    cout << "Modelo procedural gerado: " << figure << " (" << modelData.vertices.size()
+         << " vértices, " << modelData.faces.size() << " faces)" << endl;
+    
     return true;
 }
 
+/**
+ * @brief Carrega o modelo de um trabalho conforme o tipo (bloco, procedural ou ficheiro).
+ *
+ * Corre nas threads de carregamento: não usa OpenGL nem modelDataList.
+ */
+bool loadJobModel(const LoadJob& job, ModelData& modelData) {
+    if (job.chunk >= 0) {
+        Mesh mesh;
+        if (!readChunk(job.model.filename, job.chunkInfo, mesh)) {
+            return false;
+        }
+        modelData.filename = job.model.filename + "#" + to_string(job.chunk);
+        copyMesh(mesh, modelData);
+        return true;
+    }
+    
+    return job.model.procedural.empty() ? loadModel(modelData, job.model.filename)
+                                        : loadProceduralModel(modelData, job.model);
+}
+
+/**
+ * @brief Resolve os índices de SceneModel para os textos de Scene::strings.
+ */
+Model sceneModelToModel(const Scene& scene, const SceneModel& sceneModel) {
+    Model model;
+    if (sceneModel.procedural != NO_INDEX) {
+        model.procedural = scene.strings[sceneModel.procedural];
+        for (uint32_t p = sceneModel.firstParam; p < sceneModel.firstParam + sceneModel.paramCount; p++) {
+            model.params[scene.strings[scene.params[p].name]] = scene.params[p].value;
+        }
+    } else {
+        model.filename = scene.strings[sceneModel.file];
+    }
+    return model;
+}
+
+/**
+ * @brief Expande as geometrias da cena em trabalhos de carregamento.
+ */
+vector<LoadJob> expandModels(const Scene& scene) {
+    vector<LoadJob> jobs;
+    jobs.reserve(scene.assets.size());
+    for (uint32_t a = 0; a < scene.assets.size(); a++) {
+        LoadJob job;
+        job.model = sceneModelToModel(scene, scene.models[scene.assets[a]]);
+        job.asset = a;
+        const Model& model = job.model;
+        
+        // Terrenos por blocos (3DC1): cada bloco é carregado como um modelo independente
+        vector<ChunkInfo> chunks;
+        if (model.procedural.empty() && readChunkTable(model.filename, chunks)) {
+            for (size_t i = 0; i < chunks.size(); i++) {
+                job.chunk = (int)i;
+                job.chunkInfo = chunks[i];
+                jobs.push_back(job);
+            }
+            continue;
+        }
+        
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+/**
+ * @brief Os trabalhos de cada geometria são contíguos e seguem a ordem de Scene::assets.
+ */
+void mapAssetSlots() {
+    assetSlots.assign(scene.assets.size() + 1, sceneJobs.size());
+    for (size_t i = sceneJobs.size(); i-- > 0;) {
+        assetSlots[sceneJobs[i].asset] = i;
+    }
+    // Geometrias sem trabalhos (terreno sem blocos) ficam com um intervalo vazio
+    for (size_t a = scene.assets.size(); a-- > 0;) {
+        assetSlots[a] = min(assetSlots[a], assetSlots[a + 1]);
+    }
+}
+
+/**
+ * @brief Entrada provisória: nome, AABB estimada e a versão do trabalho.
+ */
+ModelData makePlaceholder(const LoadJob& job) {
+    ModelData placeholder;
+    placeholder.pending = true;
+    placeholder.version = job.version;
+    
+    if (job.chunk >= 0) {
+        placeholder.filename = job.model.filename + "#" + to_string(job.chunk);
+        memcpy(placeholder.bounds, job.chunkInfo.min, sizeof(job.chunkInfo.min));
+        memcpy(placeholder.bounds + 3, job.chunkInfo.max, sizeof(job.chunkInfo.max));
+    } else {
+        placeholder.filename = job.model.procedural.empty() ? job.model.filename : job.model.procedural;
+        placeholderBounds(job.model, placeholder.bounds);
+    }
+    return placeholder;
+}
+
+/**
+ * @brief Ficheiro e bloco, ou figura e parâmetros para modelos procedurais.
+ */
+string jobKey(const LoadJob& job) {
+    if (job.model.procedural.empty()) {
+        return job.model.filename + "#" + to_string(job.chunk);
+    }
+    
+    string key = "procedural:" + job.model.procedural;
+    for (const auto& param : job.model.params) {
+        key += " " + param.first + "=" + to_string(param.second);
+    }
+    return key;
+}
+
+/**
+ * @brief Lança min(núcleos, MAX_LOADER_THREADS, trabalhos) threads sobre um LoadBatch.
+ */
+void startLoading(const vector<LoadJob>& jobs) {
+    // Junta as threads dos conjuntos anteriores que já terminaram
+    for (size_t i = 0; i < loadBatches.size();) {
+        if (loadBatches[i]->active.load() == 0) {
+            for (thread& loader : loadBatches[i]->threads) {
+                loader.join();
+            }
+            loadBatches.erase(loadBatches.begin() + i);
+        } else {
+            i++;
+        }
+    }
+    
+    if (jobs.empty()) {
+        return;
+    }
+    
+    shared_ptr<LoadBatch> batch = make_shared<LoadBatch>();
+    batch->jobs = jobs;
+    
+    unsigned int loaders = min(max(thread::hardware_concurrency(), 1u), MAX_LOADER_THREADS);
+    loaders = (unsigned int)min((size_t)loaders, jobs.size());
+    cout << "\nCarregando " << jobs.size() << " modelos em " << loaders << " threads..." << endl;
+    batch->active = loaders;
+    for (unsigned int i = 0; i < loaders; i++) {
+        batch->threads.emplace_back(loaderThread, batch);
+    }
+    loadBatches.push_back(batch);
+}
+
+void stopLoading() {
+    loadersStopping = true;
+    for (const shared_ptr<LoadBatch>& batch : loadBatches) {
+        for (thread& loader : batch->threads) {
+            loader.join();
+        }
+    }
+    loadBatches.clear();
+}
+
+/**
+ * @brief Estima a AABB de um modelo sem o carregar.
+ */
+void placeholderBounds(const Model& model, float bounds[6]) {
+    float extent[6] = {-1, -1, -1, 1, 1, 1};
+    
+    if (!model.procedural.empty()) {
+        auto param = [&model](const string& name, float fallback) {
+            auto it = model.params.find(name);
+            return it != model.params.end() ? it->second : fallback;
+        };
+        
+        const string& figure = model.procedural;
+        if (figure == "sphere" || figure == "icosphere") {
+            float r = param("radius", 1);
+            float sphere[6] = {-r, -r, -r, r, r, r};
+            memcpy(extent, sphere, sizeof(extent));
+        } else if (figure == "box") {
+            float h = param("size", 1) / 2;
+            float box[6] = {-h, -h, -h, h, h, h};
+            memcpy(extent, box, sizeof(extent));
+        } else if (figure == "plane") {
+            float h = param("length", 1) / 2;
+            float plane[6] = {-h, 0, -h, h, 0, h};
+            memcpy(extent, plane, sizeof(extent));
+        } else if (figure == "cone") {
+            float r = param("radius", 1);
+            float cone[6] = {-r, 0, -r, r, param("height", 2), r};
+            memcpy(extent, cone, sizeof(extent));
+        }
+    } else {
+        // Ficheiro quantizado: a AABB está no cabeçalho (depois do identificador e das contagens)
+        ifstream file(model.filename, ios::binary);
+        unsigned char header[12 + sizeof(extent)];
+        if (file.read((char*)header, sizeof(header)) && isQuantizedMesh(header, sizeof(header))) {
+            memcpy(extent, header + 12, sizeof(extent));
+        } else if (useModelCache) {
+            readModelCacheBounds(modelCachePath(modelCacheDir, model.filename), extent);
+        }
+    }
+    
+    memcpy(bounds, extent, sizeof(extent));
+}
+
+/**
+ * @brief Calcula a AABB de ModelData a partir dos vértices.
+ */
+void computeBounds(ModelData& modelData) {
+    for (size_t v = 0; v < modelData.vertices.size(); v++) {
+        const float coords[3] = {modelData.vertices[v].x, modelData.vertices[v].y, modelData.vertices[v].z};
+        for (int k = 0; k < 3; k++) {
+            if (v == 0 || coords[k] < modelData.bounds[k]) modelData.bounds[k] = coords[k];
+            if (v == 0 || coords[k] > modelData.bounds[3 + k]) modelData.bounds[3 + k] = coords[k];
+        }
+    }
+}
+
+/**
+ * @brief Carrega os trabalhos de um LoadBatch até se esgotarem.
+ */
+void loaderThread(shared_ptr<LoadBatch> batch) {
+    size_t index;
+    while (!loadersStopping.load(memory_order_relaxed) && (index = batch->next.fetch_add(1)) < batch->jobs.size()) {
+        const LoadJob& job = batch->jobs[index];
+        unique_ptr<ModelData> modelData(new ModelData());
+        size_t allocationsBefore = threadAllocationCount();
+        
+        if (loadJobModel(job, *modelData)) {
+            if (countAllocations) {
+                size_t count = threadAllocationCount() - allocationsBefore;
+                cout << "Alocações " << modelData->filename << ": " << count << " ("
+                     << (double)count / max<size_t>(modelData->vertices.size(), 1) << " por vértice)" << endl;
+            }
+            if (optimizeModels) {
+                optimizeModel(*modelData);
+            }
+            computeBounds(*modelData);
+            modelData->version = job.version;
+        } else {
+            cerr << "Aviso: falha ao carregar modelo: "
+                 << (job.model.procedural.empty() ? job.model.filename : job.model.procedural) << endl;
+            modelData.reset();
+        }
+        
+        loadedModels.push(LoadResult{job.slot, job.version, move(modelData)});
+    }
+    batch->active--;
+}
+
+/**
+ * @brief Move os modelos carregados para modelDataList, respeitando o orçamento do frame.
+ *
+ * Pelo menos um modelo é publicado por frame, para o carregamento avançar
+ * sempre; os restantes ficam na fila para os frames seguintes. Resultados
+ * de modelos que entretanto foram recarregados ou removidos são descartados.
+ */
+void publishLoadedModels() {
+    if (pendingModels == 0) {
+        return;
+    }
+    
+    auto start = chrono::steady_clock::now();
+    LoadResult result;
+    while (pendingModels > 0 && loadedModels.pop(result)) {
+        if (result.slot >= modelDataList.size() || !modelDataList[result.slot].pending ||
+            modelDataList[result.slot].version != result.version) {
+            continue;
+        }
+        
+        ModelData& slot = modelDataList[result.slot];
+        if (result.data) {
+            slot = move(*result.data);
+        } else {
+            slot.pending = false;
+        }
+        pendingModels--;
+        frameRevision++;
+        
+        chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+        if (elapsed.count() >= UPLOAD_BUDGET_MS) {
+            break;
+        }
+    }
+    
+    if (pendingModels == 0) {
+        size_t loadedCount = 0;
+        for (const ModelData& modelData : modelDataList) {
+            loadedCount += modelData.loaded ? 1 : 0;
+        }
+        cout << "\nTotal de modelos carregados com sucesso: " << loadedCount
+             << " de " << modelDataList.size() << endl;
+    }
+}
+
+/**
+ * @brief Pede um novo frame a cada 16 ms até todos os modelos estarem publicados.
+ */
+void loadingTimer(int value) {
+    glutPostRedisplay();
+    if (pendingModels > 0) {
+        glutTimerFunc(16, loadingTimer, value);
+    } else {
+        loadingTimerActive = false;
+    }
+}
+
+void ensureLoadingTimer() {
+    if (!loadingTimerActive) {
+        loadingTimerActive = true;
+        glutTimerFunc(16, loadingTimer, 0);
+    }
+}
+
+/**
+ * @brief Pede um novo frame a cada ANIMATION_INTERVAL_MS; para se a cena recarregada deixar de ser animada.
+ */
+void animationTimer(int value) {
+    if (scene.isAnimated()) {
+        glutPostRedisplay();
+        glutTimerFunc(ANIMATION_INTERVAL_MS, animationTimer, value);
+    } else {
+        animationTimerActive = false;
+    }
+}
+
+void ensureAnimationTimer() {
+    if (!animationTimerActive && scene.isAnimated()) {
+        animationTimerActive = true;
+        glutTimerFunc(ANIMATION_INTERVAL_MS, animationTimer, 0);
+    }
+}
+
+/**
+ * @brief Compara a nova cena com a atual pela chave de cada trabalho (jobKey).
+ *
+ * Os modelos já carregados com a mesma chave e ficheiro inalterado passam
+ * para a nova lista tal como estão; os restantes recebem uma nova versão e
+ * uma caixa provisória.
+ */
+void reloadScene(const set<string>& changed) {
+    waitFrameUpdate();
+    Scene newScene;
+    bool sceneChanged = false;
+    if (changed.count(sceneFile)) {
+        // A câmera e a janela atuais mantêm-se: só a hierarquia é lida do XML
+        Window newWindow;
+        Camera newCamera;
+        cout << "\nCena alterada, a recarregar: " << sceneFile << endl;
+        if (SimpleParser::parseXMLFile(sceneFile, newWindow, newCamera, newScene)) {
+            sceneChanged = true;
+        } else {
+            cerr << "Aviso: a cena alterada é inválida, mantém-se a anterior" << endl;
+        }
+    }
+    
+    // Modelos atuais, por chave
+    multimap<string, size_t> current;
+    for (size_t i = 0; i < sceneJobs.size(); i++) {
+        current.insert(make_pair(jobKey(sceneJobs[i]), i));
+    }
+    
+    vector<LoadJob> jobs = expandModels(sceneChanged ? newScene : scene);
+    vector<LoadJob> toLoad;
+    vector<ModelData> newList;
+    newList.reserve(jobs.size());
+    size_t kept = 0;
+    
+    for (size_t i = 0; i < jobs.size(); i++) {
+        LoadJob& job = jobs[i];
+        job.slot = i;
+        
+        // Os modelos ainda a carregar são pedidos de novo: o resultado antigo
+        // traz o índice antigo em modelDataList e será descartado
+        auto match = current.find(jobKey(job));
+        bool fileChanged = job.model.procedural.empty() && changed.count(job.model.filename);
+        if (match != current.end() && !fileChanged && !modelDataList[match->second].pending) {
+            newList.push_back(move(modelDataList[match->second]));
+            current.erase(match);
+            kept++;
+        } else {
+            if (match != current.end()) {
+                current.erase(match);
+            }
+            job.version = nextVersion++;
+            newList.push_back(makePlaceholder(job));
+            toLoad.push_back(job);
+        }
+    }
+    
+    cout << "Recarregamento: " << kept << " mantidos, " << toLoad.size() << " a carregar, "
+         << current.size() << " removidos" << endl;
+    
+    modelDataList.swap(newList);
+    sceneJobs = move(jobs);
+    if (sceneChanged) {
+        scene = move(newScene);
+    }
+    mapAssetSlots();
+    markAnimatedGroups();
+    resetStaticBatches();
+    
+    pendingModels = 0;
+    for (const ModelData& modelData : modelDataList) {
+        pendingModels += modelData.pending ? 1 : 0;
+    }
+    
+    startLoading(toLoad);
+    ensureLoadingTimer();
+    ensureAnimationTimer();
+    watcher->setFiles(watchedFiles());
+}
+
+vector<string> watchedFiles() {
+    vector<string> files;
+    files.push_back(sceneFile);
+    for (uint32_t model : scene.assets) {
+        if (scene.models[model].file != NO_INDEX) {
+            files.push_back(scene.strings[scene.models[model].file]);
+        }
+    }
+    return files;
+}
+
+void watchTimer(int value) {
+    set<string> changed = watcher->poll();
+    if (!changed.empty()) {
+        reloadScene(changed);
+        glutPostRedisplay();
+    }
+    glutTimerFunc(WATCH_INTERVAL_MS, watchTimer, value);
+}
+
+/**
+ * @brief Otimiza o modelo com optimizeMesh() do gerador, convertendo-o numa Mesh.
+ *
+ * Mostra o ACMR (vértices transformados por triângulo) antes e depois.
+ */
+void optimizeModel(ModelData& modelData) {
+    Mesh mesh;
+    mesh.vertices.reserve(modelData.vertices.size() * 3);
+    for (const Vertex& vertex : modelData.vertices) {
+        mesh.vertices.insert(mesh.vertices.end(), {vertex.x, vertex.y, vertex.z});
+    }
+    mesh.indices.reserve(modelData.faces.size() * 3);
+    for (const Face& face : modelData.faces) {
+        mesh.indices.insert(mesh.indices.end(), {(unsigned int)face.v1, (unsigned int)face.v2, (unsigned int)face.v3});
+    }
+    
+    // Modelos já otimizados (ex.: gerados com --optimize) mantêm a ordem dos triângulos
+    float acmrBefore, acmrAfter;
+    optimizeMesh(mesh, &acmrBefore, &acmrAfter);
+    copyMesh(mesh, modelData);
+    
+    if (acmrAfter >= acmrBefore) {
+        cout << "ACMR " << modelData.filename << ": " << acmrBefore << " (mantido)" << endl;
+    } else {
+        cout << "ACMR " << modelData.filename << ": " << acmrBefore << " -> " << acmrAfter << endl;
+    }
+}
+
+/**
+ * @brief Carrega os modelos da cena (sem repetições) e escreve o pacote.
+ *
+ * Os modelos que falham são omitidos, com um aviso.
+ */
+bool buildScenePack(const string& scenePath, const string& packPath) {
+    Camera sceneCamera;
+    Scene packScene;
+    if (!SimpleParser::parseXMLFile(scenePath, window, sceneCamera, packScene)) {
+        cerr << "Erro: falha ao fazer parse do arquivo XML." << endl;
+        return false;
+    }
+    
+    // Carrega cada geometria uma vez (um trabalho por geometria ou bloco, pela
+    // ordem de Scene::assets); os modelos da cena referem-se a ela por asset
+    vector<LoadJob> jobs = expandModels(packScene);
+    vector<ModelData> meshes;
+    ScenePack pack;
+    pack.assetMeshes.assign(packScene.assets.size() + 1, 0);
+    
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const LoadJob& job = jobs[i];
+        ModelData modelData;
+        if (!loadJobModel(job, modelData)) {
+            cerr << "Aviso: falha ao carregar modelo, omitido do pacote: "
+                 << (job.model.procedural.empty() ? job.model.filename : job.model.procedural) << endl;
+            continue;
+        }
+        if (optimizeModels) {
+            optimizeModel(modelData);
+        }
+        computeBounds(modelData);
+        
+        pack.assetMeshes[job.asset + 1]++;
+        meshes.push_back(move(modelData));
+    }
+    
+    // Intervalo de malhas de cada geometria (vazio se falhou)
+    for (size_t a = 0; a < packScene.assets.size(); a++) {
+        pack.assetMeshes[a + 1] += pack.assetMeshes[a];
+    }
+    
+    // As malhas do pacote apontam para os modelos carregados
+    for (const ModelData& modelData : meshes) {
+        PackMesh mesh;
+        mesh.name = modelData.filename;
+        mesh.vertices = (const float*)modelData.vertices.data();
+        mesh.vertexCount = (uint32_t)modelData.vertices.size();
+        mesh.indices = (const uint32_t*)modelData.faces.data();
+        mesh.indexCount = (uint32_t)modelData.faces.size() * 3;
+        memcpy(mesh.bounds, modelData.bounds, sizeof(mesh.bounds));
+        pack.meshes.push_back(mesh);
+    }
+    
+    pack.windowWidth = window.width;
+    pack.windowHeight = window.height;
+    float cameraValues[12] = {
+        sceneCamera.getPosX(), sceneCamera.getPosY(), sceneCamera.getPosZ(),
+        sceneCamera.getLookAtX(), sceneCamera.getLookAtY(), sceneCamera.getLookAtZ(),
+        sceneCamera.getUpX(), sceneCamera.getUpY(), sceneCamera.getUpZ(),
+        sceneCamera.getFov(), sceneCamera.getNearPlane(), sceneCamera.getFarPlane()
+    };
+    memcpy(pack.camera, cameraValues, sizeof(cameraValues));
+    pack.scene = move(packScene);
+    
+    if (!writeScenePack(packPath, pack)) {
+        cerr << "Erro: falha ao escrever o pacote: " << packPath << endl;
+        return false;
+    }
+    
+    cout << "\nPacote guardado em: " << packPath << " (" << pack.meshes.size() << " malhas, "
+         << pack.scene.models.size() << " modelos, " << pack.scene.groups.size() << " grupos)" << endl;
+    return true;
+}
+
+/**
+ * @brief Copia cada malha do pacote mapeado uma única vez para modelDataList.
+ */
+bool loadScenePack(const string& packPath) {
+    ScenePack pack;
+    if (!openScenePack(packPath, pack)) {
+        return false;
+    }
+    
+    window.width = pack.windowWidth;
+    window.height = pack.windowHeight;
+    camera->setPosition(pack.camera[0], pack.camera[1], pack.camera[2]);
+    camera->setLookAt(pack.camera[3], pack.camera[4], pack.camera[5]);
+    camera->setUp(pack.camera[6], pack.camera[7], pack.camera[8]);
+    camera->setProjection(pack.camera[9], pack.camera[10], pack.camera[11]);
+    
+    modelDataList.resize(pack.meshes.size());
+    for (size_t i = 0; i < pack.meshes.size(); i++) {
+        const PackMesh& mesh = pack.meshes[i];
+        ModelData& modelData = modelDataList[i];
+        
+        modelData.filename = mesh.name;
+        modelData.vertices.resize(mesh.vertexCount);
+        modelData.faces.resize(mesh.indexCount / 3);
+        memcpy((void*)modelData.vertices.data(), mesh.vertices, (size_t)mesh.vertexCount * sizeof(Vertex));
+        memcpy((void*)modelData.faces.data(), mesh.indices, (size_t)(mesh.indexCount / 3) * sizeof(Face));
+        memcpy(modelData.bounds, mesh.bounds, sizeof(mesh.bounds));
+        modelData.loaded = true;
+    }
+    
+    // A hierarquia é desenhada como a de uma cena XML, com os modelos já carregados
+    scene = move(pack.scene);
+    assetSlots.assign(pack.assetMeshes.begin(), pack.assetMeshes.end());
+    markAnimatedGroups();
+    
+    cout << "Pacote carregado: " << pack.meshes.size() << " malhas, "
+         << scene.models.size() << " modelos, " << scene.groups.size() << " grupos" << endl;
+    return true;
+}
+
+/**
+ * @brief Analisa cada ficheiro com e sem SIMD e mostra os MB/s.
+ */
+int benchParse(const vector<string>& files) {
+    XMLDocument doc;
+    doc.SetReuseBuffers(true);
+    int result = 0;
+    
+    for (const string& path : files) {
+        MappedFile source;
+        if (!source.open(path)) {
+            cerr << "Erro ao abrir o ficheiro: " << path << endl;
+            result = 1;
+            continue;
+        }
+        
+        double rates[2] = {0, 0};
+        for (int simd = 0; simd < 2; simd++) {
+            XMLUtil::SetSIMDEnabled(simd == 1);
+            int runs = 0;
+            auto start = chrono::steady_clock::now();
+            chrono::duration<double> elapsed;
+            do {
+                doc.Parse((const char*)source.data(), source.size());
+                runs++;
+                elapsed = chrono::steady_clock::now() - start;
+            } while (elapsed.count() < BENCH_PARSE_SECONDS || runs < 3);
+            
+            if (doc.Error()) {
+                cerr << "Erro de parse em " << path << ": " << doc.ErrorStr() << endl;
+                result = 1;
+                break;
+            }
+            rates[simd] = (double)source.size() * runs / elapsed.count() / (1024.0 * 1024.0);
+        }
+        
+        cout << path << " (" << source.size() / 1024 << " KB): "
+             << rates[0] << " MB/s byte a byte, "
+             << rates[1] << " MB/s " << XMLUtil::SIMDLevel()
+             << " (" << (rates[0] > 0 ? rates[1] / rates[0] : 0) << "x)" << endl;
+        doc.Clear();
+    }
+    
+    XMLUtil::SetSIMDEnabled(true);
+    return result;
+}
+
 /**
  * @brief Desenha os eixos coordenados X, Y, Z na origem em cores padrão.
  *
@@ -377,6 +1753,28 @@ void drawAxes() {
 }
 
 
+/**
+ * @brief Desenha as 12 arestas da AABB a cinzento.
+ */
+void drawBoundingBox(const float bounds[6]) {
+    glColor3f(0.5f, 0.5f, 0.5f);
+    glBegin(GL_LINES);
+    for (int axis = 0; axis < 3; axis++) {
+        // 4 arestas paralelas a cada eixo
+        int a = (axis + 1) % 3, b = (axis + 2) % 3;
+        for (int corner = 0; corner < 4; corner++) {
+            float start[3], end[3];
+            start[a] = end[a] = bounds[(corner & 1) ? 3 + a : a];
+            start[b] = end[b] = bounds[(corner & 2) ? 3 + b : b];
+            start[axis] = bounds[axis];
+            end[axis] = bounds[3 + axis];
+            glVertex3fv(start);
+            glVertex3fv(end);
+        }
+    }
+    glEnd();
+}
+
 
 /**
  * @brief Callback de redimensionamento de janela.
@@ -392,13 +1790,13 @@ void changeSize(int w, int h) {
     
     // Seleciona e configura a matriz de projeção
     glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
     
     // Define a área de visualização (viewport)
     glViewport(0, 0, w, h);
     
     // Define a perspectiva com base nos parâmetros da câmera
-    gluPerspective(camera->getFov(), ratio, camera->getNearPlane(), camera->getFarPlane());
+    projection = mat4::perspective(camera->getFov(), ratio, camera->getNearPlane(), camera->getFarPlane());
+    glLoadMatrixf(projection.m);
     
     // Retorna para a matriz de visão (modelview)
     glMatrixMode(GL_MODELVIEW);
@@ -406,6 +1804,529 @@ void changeSize(int w, int h) {
 
 
 
+/**
+ * @brief Desenha os triângulos de um modelo.
+ *
+ * Com <color>, o modelo é desenhado com a cor difusa; caso contrário as
+ * faces alternam entre laranja e azul.
+ */
+void drawModel(const ModelData& modelData, const SceneModel* sceneModel) {
+    // Modelos ainda a carregar: caixa provisória
+    if (modelData.pending) {
+        drawBoundingBox(modelData.bounds);
+        return;
+    }
+    
+    // Ignora modelos não carregados
+    if (!modelData.loaded) return;
+    
+    const bool colored = sceneModel && sceneModel->hasColor;
+    if (colored) {
+        glColor3f(sceneModel->color.diffuse[0], sceneModel->color.diffuse[1], sceneModel->color.diffuse[2]);
+    }
+    
+    // Se o modelo tem faces definidas, usa-as para renderização
+    if (!modelData.faces.empty()) {
+        glBegin(GL_TRIANGLES);
+        
+        // Renderiza cada face (triângulo) do modelo
+        for (const Face& face : modelData.faces) {
+            // Alterna cores para melhor visualização (modelos sem <color>)
+            static int colorToggle = 0;
+            if (!colored) {
+                if (colorToggle % 2 == 0) {
+                    glColor3f(0.8f, 0.6f, 0.2f);  // Laranja
+                } else {
+                    glColor3f(0.2f, 0.6f, 0.8f);  // Azul
+                }
+            }
+            colorToggle++;
+            
+            // Desenha o triângulo usando os índices de vértices
+            const Vertex& v1 = modelData.vertices[face.v1];
+            const Vertex& v2 = modelData.vertices[face.v2];
+            const Vertex& v3 = modelData.vertices[face.v3];
+            
+            glVertex3f(v1.x, v1.y, v1.z);
+            glVertex3f(v2.x, v2.y, v2.z);
+            glVertex3f(v3.x, v3.y, v3.z);
+        }
+        glEnd();
+    } else {
+        // Fallback: renderiza vértices diretamente em grupos de 3 (triângulos)
+        glBegin(GL_TRIANGLES);
+        for (size_t i = 0; i < modelData.vertices.size(); i += 3) {
+            if (i + 2 < modelData.vertices.size()) {
+                // Alterna cores para melhor visualização (modelos sem <color>)
+                static int colorToggle = 0;
+                if (!colored) {
+                    if (colorToggle % 2 == 0) {
+                        glColor3f(0.8f, 0.6f, 0.2f);  // Laranja
+                    } else {
+                        glColor3f(0.2f, 0.6f, 0.8f);  // Azul
+                    }
+                }
+                colorToggle++;
+                
+                // Desenha o triângulo
+                const Vertex& v1 = modelData.vertices[i];
+                const Vertex& v2 = modelData.vertices[i + 1];
+                const Vertex& v3 = modelData.vertices[i + 2];
+                
+                glVertex3f(v1.x, v1.y, v1.z);
+                glVertex3f(v2.x, v2.y, v2.z);
+                glVertex3f(v3.x, v3.y, v3.z);
+            }
+        }
+        glEnd();
+    }
+}
+
+
+/**
+ * @brief Percorre Scene::groups com uma pilha de intervalos de grupos.
+ *
+ * Um grupo sai da lista de abertos quando se passa o fim dos seus
+ * descendentes (SceneGroup::end). Num <use>, a subárvore do protótipo é
+ * percorrida num novo intervalo antes de continuar depois do <use>.
+ */
+template <typename Enter, typename Leave>
+void walkGroups(Enter enter, Leave leave) {
+    // Intervalos de grupos a percorrer: a cena e as instâncias em curso
+    struct Range {
+        uint32_t next;
+        uint32_t end;
+        size_t openBase;    ///< Grupos abertos antes do intervalo
+    };
+    static vector<Range> ranges;
+    static vector<uint32_t> open;
+    ranges.assign(1, Range{0, (uint32_t)scene.groups.size(), 0});
+    open.clear();
+    
+    while (!ranges.empty()) {
+        Range& range = ranges.back();
+        while (open.size() > range.openBase && range.next >= scene.groups[open.back()].end) {
+            leave(open.back());
+            open.pop_back();
+        }
+        if (range.next == range.end) {
+            ranges.pop_back();
+            continue;
+        }
+        
+        uint32_t g = range.next++;
+        if (!enter(g)) {
+            range.next = scene.groups[g].end;
+            continue;
+        }
+        open.push_back(g);
+        if (scene.groups[g].instance != NO_INDEX) {
+            ranges.push_back(Range{scene.groups[g].instance, scene.groups[scene.groups[g].instance].end, open.size()});
+        }
+    }
+}
+
+
+/**
+ * @brief Desenha o frame preparado em segundo plano e começa a preparar o seguinte.
+ *
+ * O frame preparado só é usado se a câmera, a projeção, os modelos e a cena
+ * não mudaram desde que a preparação começou e se o tempo previsto difere do
+ * real menos de meio intervalo entre frames; caso contrário é atualizado
+ * aqui, antes de ser desenhado.
+ * Com a preparação do frame seguinte, a atualização no CPU sobrepõe-se ao
+ * desenho e à espera em glutSwapBuffers.
+ */
+void drawGroups(float time) {
+    if (!framePlan.valid) {
+        buildFramePlan();
+    }
+    mat4 view = camera->viewMatrix();
+    
+    FrameData& frame = frames[currentFrame];
+    float elapsed = lastFrameTime >= 0 ? time - lastFrameTime : 0;
+    bool stale = !frame.ready || frame.revision != frameRevision ||
+                 (framePlan.animated && fabsf(frame.time - time) > FRAME_PREDICTION_TOLERANCE * elapsed) ||
+                 memcmp(frame.view.m, view.m, sizeof(view.m)) != 0 ||
+                 memcmp(frame.projection.m, projection.m, sizeof(projection.m)) != 0;
+    if (stale) {
+        frame.time = time;
+        frame.view = view;
+        frame.projection = projection;
+        frame.revision = frameRevision;
+        updateFrame(frame);
+    }
+    
+    // O frame seguinte é preparado para o tempo previsto com o intervalo entre os dois últimos
+    FrameData& next = frames[1 - currentFrame];
+    next.time = time + min(elapsed, MAX_PREDICTED_INTERVAL);
+    next.view = view;
+    next.projection = projection;
+    next.revision = frameRevision;
+    next.ready = false;
+    frameUpdater->start([&next] { updateFrame(next); });
+    
+    submitFrame(frame);
+    frame.ready = false;
+    currentFrame = 1 - currentFrame;
+    lastFrameTime = time;
+}
+
+void waitFrameUpdate() {
+    if (frameUpdater) {
+        frameUpdater->wait();
+    }
+}
+
+
+/**
+ * @brief Achata a hierarquia em nós e divide-a em partições.
+ *
+ * Uma subárvore com até target nós fica numa só partição, junto com as
+ * subárvores irmãs seguintes enquanto couberem. Os nós com subárvores maiores
+ * ficam isolados como nós de cabeça, atualizados antes das partições; como
+ * estão em pré-ordem, o pai de um nó de cabeça é também um nó de cabeça.
+ */
+void buildFramePlan() {
+    FramePlan& plan = framePlan;
+    plan.groups.clear();
+    plan.parents.clear();
+    plan.locals.clear();
+    plan.items.clear();
+    plan.partitions.clear();
+    
+    // Nós, com o pai absoluto e o fim da subárvore de cada um
+    vector<uint32_t> ends, openNodes;
+    vector<bool> draws;
+    int dynamicDepth = 0;
+    walkGroups(
+        [&](uint32_t g) {
+            const SceneGroup& group = scene.groups[g];
+            if (staticBatchesReady && dynamicDepth == 0 && !(groupAnimation[g] & ANIMATED_SUBTREE)) {
+                return false;  // Toda a subárvore está nos lotes
+            }
+            
+            mat4 local = mat4::identity();
+            for (uint32_t t = group.firstTransform; t < group.firstTransform + group.transformCount; t++) {
+                local = local * scene.transformMatrix(scene.transforms[t], 0);
+            }
+            dynamicDepth += (groupAnimation[g] & ANIMATED_GROUP) ? 1 : 0;
+            plan.parents.push_back(openNodes.empty() ? UINT32_MAX : openNodes.back());
+            openNodes.push_back((uint32_t)plan.groups.size());
+            plan.groups.push_back(g);
+            plan.locals.push_back(local);
+            ends.push_back(0);
+            draws.push_back(!staticBatchesReady || dynamicDepth > 0);
+            return true;
+        },
+        [&](uint32_t g) {
+            dynamicDepth -= (groupAnimation[g] & ANIMATED_GROUP) ? 1 : 0;
+            ends[openNodes.back()] = (uint32_t)plan.groups.size();
+            openNodes.pop_back();
+        });
+    
+    // Modelos de cada nó, pela ordem dos nós
+    uint32_t nodeCount = (uint32_t)plan.groups.size();
+    vector<uint32_t> firstItems(nodeCount + 1);
+    for (uint32_t node = 0; node < nodeCount; node++) {
+        firstItems[node] = (uint32_t)plan.items.size();
+        const SceneGroup& group = scene.groups[plan.groups[node]];
+        for (uint32_t m = group.firstModel; m < group.firstModel + group.modelCount && draws[node]; m++) {
+            uint32_t asset = scene.models[m].asset;
+            for (size_t slot = assetSlots[asset]; slot < assetSlots[asset + 1]; slot++) {
+                plan.items.push_back(DrawCommand{node, (uint32_t)slot, m});
+            }
+        }
+    }
+    firstItems[nodeCount] = (uint32_t)plan.items.size();
+    
+    // Cabeças e partições; várias partições por thread equilibram subárvores desiguais
+    size_t target = max(FRAME_NODES_PER_JOB, (size_t)nodeCount / (4 * frameJobs->size()));
+    vector<FramePartition> heads, subtrees;
+    for (uint32_t node = 0; node < nodeCount;) {
+        uint32_t parent = plan.parents[node];
+        if (ends[node] - node > target) {
+            heads.push_back(FramePartition{node, node + 1, parent, firstItems[node], firstItems[node + 1]});
+            node++;
+            continue;
+        }
+        uint32_t end = ends[node];
+        while (end < nodeCount && plan.parents[end] == parent && ends[end] - node <= target) {
+            end = ends[end];
+        }
+        subtrees.push_back(FramePartition{node, end, parent, firstItems[node], firstItems[end]});
+        node = end;
+    }
+    plan.headCount = heads.size();
+    plan.animated = false;
+    for (uint32_t g : plan.groups) {
+        plan.animated = plan.animated || (groupAnimation[g] & ANIMATED_GROUP);
+    }
+    plan.partitions = move(heads);
+    plan.partitions.insert(plan.partitions.end(), subtrees.begin(), subtrees.end());
+    
+    // Os pais passam a ser relativos à partição; as raízes usam FramePartition::parent
+    for (const FramePartition& partition : plan.partitions) {
+        for (uint32_t node = partition.begin; node < partition.end; node++) {
+            uint32_t parent = plan.parents[node];
+            plan.parents[node] = parent >= partition.begin && parent < partition.end ? parent - partition.begin : UINT32_MAX;
+        }
+    }
+    plan.valid = true;
+}
+
+
+// Ordem da lista de desenho: por modelo, para desenhar seguidas as instâncias da mesma geometria
+static bool drawsBefore(const DrawCommand& a, const DrawCommand& b) {
+    return a.slot != b.slot ? a.slot < b.slot : a.node < b.node;
+}
+
+void updatePartition(size_t p, float time, const Frustum& frustum, FrameData& frame) {
+    FramePlan& plan = framePlan;
+    const FramePartition& partition = plan.partitions[p];
+    
+    // Animação: só os grupos temporizados mudam de matriz
+    for (uint32_t node = partition.begin; node < partition.end; node++) {
+        uint32_t g = plan.groups[node];
+        if (!(groupAnimation[g] & ANIMATED_GROUP)) {
+            continue;
+        }
+        const SceneGroup& group = scene.groups[g];
+        mat4 local = mat4::identity();
+        for (uint32_t t = group.firstTransform; t < group.firstTransform + group.transformCount; t++) {
+            local = local * scene.transformMatrix(scene.transforms[t], time);
+        }
+        plan.locals[node] = local;
+    }
+    
+    const mat4& root = partition.parent == UINT32_MAX ? frame.view : frame.worlds[partition.parent];
+    propagateMatrices(root, plan.parents.data() + partition.begin, plan.locals.data() + partition.begin,
+                      frame.worlds.data() + partition.begin, partition.end - partition.begin);
+    
+    // Seleção dos modelos dentro da vista, com a AABB no espaço da câmera
+    vector<DrawCommand>& run = frame.runs[p];
+    run.clear();
+    for (uint32_t i = partition.firstItem; i < partition.endItem; i++) {
+        const DrawCommand& item = plan.items[i];
+        const ModelData& modelData = modelDataList[item.slot];
+        if (!modelData.loaded && !modelData.pending) {
+            continue;
+        }
+        if (frustumCulling) {
+            float bounds[6];
+            transformBounds(frame.worlds[item.node], modelData.bounds, bounds);
+            if (frustum.excludes(bounds)) {
+                continue;
+            }
+        }
+        run.push_back(item);
+    }
+    
+    sort(run.begin(), run.end(), drawsBefore);
+}
+
+
+/**
+ * @brief Atualiza as cabeças por ordem, as partições em paralelo e funde as listas de cada partição.
+ *
+ * A fusão é feita aos pares, também em paralelo, entre frame.draws e frame.scratch.
+ */
+void updateFrame(FrameData& frame) {
+    const FramePlan& plan = framePlan;
+    size_t partitions = plan.partitions.size();
+    frame.worlds.resize(plan.groups.size());
+    frame.runs.resize(partitions);
+    Frustum frustum = Frustum::fromMatrix(frame.projection);
+    
+    for (size_t p = 0; p < plan.headCount; p++) {
+        updatePartition(p, frame.time, frustum, frame);
+    }
+    frameJobs->run(partitions - plan.headCount, [&](size_t job) {
+        updatePartition(plan.headCount + job, frame.time, frustum, frame);
+    });
+    
+    // Junta as listas; runStarts marca o início de cada lista já ordenada
+    vector<size_t>& runStarts = frame.runStarts;
+    runStarts.assign(1, 0);
+    for (const vector<DrawCommand>& run : frame.runs) {
+        runStarts.push_back(runStarts.back() + run.size());
+    }
+    frame.draws.resize(runStarts.back());
+    frame.scratch.resize(runStarts.back());
+    frameJobs->run(partitions, [&](size_t p) {
+        copy(frame.runs[p].begin(), frame.runs[p].end(), frame.draws.begin() + runStarts[p]);
+    });
+    
+    while (runStarts.size() > 2) {
+        size_t runs = runStarts.size() - 1;
+        frameJobs->run((runs + 1) / 2, [&](size_t pair) {
+            size_t begin = runStarts[2 * pair];
+            size_t middle = runStarts[min(2 * pair + 1, runs)];
+            size_t end = runStarts[min(2 * pair + 2, runs)];
+            merge(frame.draws.begin() + begin, frame.draws.begin() + middle, frame.draws.begin() + middle,
+                  frame.draws.begin() + end, frame.scratch.begin() + begin, drawsBefore);
+        });
+        frame.draws.swap(frame.scratch);
+        for (size_t pair = 1; 2 * pair < runs; pair++) {
+            runStarts[pair] = runStarts[2 * pair];
+        }
+        runStarts[(runs + 1) / 2] = runStarts[runs];
+        runStarts.resize((runs + 1) / 2 + 1);
+    }
+    frame.ready = true;
+}
+
+
+void submitFrame(const FrameData& frame) {
+    uint32_t loadedNode = UINT32_MAX;
+    for (const DrawCommand& command : frame.draws) {
+        if (command.node != loadedNode) {
+            glLoadMatrixf(frame.worlds[command.node].m);
+            loadedNode = command.node;
+        }
+        drawModel(modelDataList[command.slot], &scene.models[command.model]);
+    }
+    glLoadMatrixf(frame.view.m);
+}
+
+
+/**
+ * @brief Marca os grupos temporizados e propaga a marca de subárvore aos pais e aos <use>.
+ *
+ * Os grupos estão em pré-ordem, pelo que uma passagem do fim para o início
+ * chega aos pais; os <use> de protótipos definidos mais à frente precisam de
+ * mais passagens, que terminam porque as referências não têm ciclos.
+ */
+void markAnimatedGroups() {
+    groupAnimation.assign(scene.groups.size(), 0);
+    for (uint32_t g = 0; g < scene.groups.size(); g++) {
+        const SceneGroup& group = scene.groups[g];
+        for (uint32_t t = group.firstTransform; t < group.firstTransform + group.transformCount; t++) {
+            TransformType type = scene.transforms[t].type;
+            if (type == TransformType::TimedTranslate || type == TransformType::TimedRotate) {
+                groupAnimation[g] = ANIMATED_GROUP | ANIMATED_SUBTREE;
+            }
+        }
+    }
+    
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint32_t g = (uint32_t)scene.groups.size(); g-- > 0;) {
+            const SceneGroup& group = scene.groups[g];
+            if (group.instance != NO_INDEX && (groupAnimation[group.instance] & ANIMATED_SUBTREE) &&
+                !(groupAnimation[g] & ANIMATED_SUBTREE)) {
+                groupAnimation[g] |= ANIMATED_SUBTREE;
+                changed = true;
+            }
+            if (group.parent != NO_INDEX && (groupAnimation[g] & ANIMATED_SUBTREE) &&
+                !(groupAnimation[group.parent] & ANIMATED_SUBTREE)) {
+                groupAnimation[group.parent] |= ANIMATED_SUBTREE;
+                changed = true;
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Acumula as matrizes dos grupos estáticos no CPU e junta os modelos com buildStaticBatches.
+ *
+ * Corre uma vez por cena, quando o último modelo é publicado.
+ */
+void buildSceneBatches() {
+    staticBatchesTried = true;
+    auto start = chrono::steady_clock::now();
+    
+    vector<BatchSource> sources;
+    auto addSource = [&sources](const ModelData& modelData, const mat4& matrix, const SceneModel* sceneModel) {
+        if (!modelData.loaded) {
+            return;
+        }
+        BatchSource source;
+        source.vertices = (const float*)modelData.vertices.data();
+        source.vertexCount = (uint32_t)modelData.vertices.size();
+        source.indices = modelData.faces.empty() ? nullptr : (const uint32_t*)modelData.faces.data();
+        source.indexCount = (uint32_t)modelData.faces.size() * 3;
+        source.matrix = matrix;
+        source.color = sceneModel && sceneModel->hasColor ? sceneModel->color.diffuse : nullptr;
+        sources.push_back(source);
+    };
+    
+    vector<mat4> matrices(1, mat4::identity());
+    walkGroups(
+        [&](uint32_t g) {
+            const SceneGroup& group = scene.groups[g];
+            if (groupAnimation[g] & ANIMATED_GROUP) {
+                return false;  // Desenhado por drawGroups
+            }
+            
+            mat4 matrix = matrices.back();
+            for (uint32_t t = group.firstTransform; t < group.firstTransform + group.transformCount; t++) {
+                matrix = matrix * scene.transformMatrix(scene.transforms[t], 0);
+            }
+            matrices.push_back(matrix);
+            for (uint32_t m = group.firstModel; m < group.firstModel + group.modelCount; m++) {
+                uint32_t asset = scene.models[m].asset;
+                for (size_t slot = assetSlots[asset]; slot < assetSlots[asset + 1]; slot++) {
+                    addSource(modelDataList[slot], matrices.back(), &scene.models[m]);
+                }
+            }
+            return true;
+        },
+        [&](uint32_t) {
+            matrices.pop_back();
+        });
+    
+    size_t vertexCount = 0;
+    for (const BatchSource& source : sources) {
+        vertexCount += batchVertexCount(source);
+    }
+    if (vertexCount > STATIC_BATCH_MAX_VERTICES) {
+        cout << "Lotes estáticos: " << vertexCount << " vértices excedem o máximo, a cena é desenhada sem lotes" << endl;
+        return;
+    }
+    
+    unsigned int threads = min(max(thread::hardware_concurrency(), 1u), MAX_LOADER_THREADS);
+    staticBatches = buildStaticBatches(sources, threads);
+    staticBatchesReady = true;
+    framePlan.valid = false;
+    frameRevision++;
+    
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    cout << "Lotes estáticos: " << staticBatches.size() << " lotes, " << sources.size() << " modelos, "
+         << vertexCount << " vértices (" << elapsed.count() << " ms)" << endl;
+}
+
+void resetStaticBatches() {
+    framePlan.valid = false;
+    frameRevision++;
+    staticBatches.clear();
+    staticBatchesTried = false;
+    staticBatchesReady = false;
+}
+
+/**
+ * @brief Lotes com cor: glDrawElements com a cor difusa; lotes sem cor: glDrawArrays com uma cor por vértice.
+ */
+void drawStaticBatches() {
+    glEnableClientState(GL_VERTEX_ARRAY);
+    for (const StaticBatch& batch : staticBatches) {
+        glVertexPointer(3, GL_FLOAT, 0, batch.vertices.data());
+        if (batch.colored) {
+            glColor3f(batch.color[0], batch.color[1], batch.color[2]);
+            glDrawElements(GL_TRIANGLES, (GLsizei)batch.indices.size(), GL_UNSIGNED_INT, batch.indices.data());
+        } else {
+            glEnableClientState(GL_COLOR_ARRAY);
+            glColorPointer(3, GL_FLOAT, 0, batch.colors.data());
+            glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(batch.vertices.size() / 3));
+            glDisableClientState(GL_COLOR_ARRAY);
+        }
+    }
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+
 /**
  * @brief Callback de renderização GLUT.
  *
@@ -416,6 +2337,16 @@ void changeSize(int w, int h) {
  * 4. Trocar buffers (double buffering)
  */
 void renderScene() {
+    // A preparação do frame lê os modelos e a cena, que mudam a seguir
+    waitFrameUpdate();
+    
+    // Publica os modelos que as threads de carregamento terminaram e, quando
+    // estão todos, junta os estáticos em lotes
+    publishLoadedModels();
+    if (!staticBatchesTried && pendingModels == 0) {
+        buildSceneBatches();
+    }
+    
     // Limpa todos os buffers de desenho
     glDisable(GL_CULL_FACE);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -438,63 +2369,11 @@ void renderScene() {
         drawAxes();
     }
     
-    // Renderiza todos os modelos carregados
-    for (const ModelData& modelData : modelDataList) {
-        // Ignora modelos não carregados
-        if (!modelData.loaded) continue;
-        
-        // Se o modelo tem faces definidas, usa-as para renderização
-        if (!modelData.faces.empty()) {
-            glBegin(GL_TRIANGLES);
-            
-            // Renderiza cada face (triângulo) do modelo
-            for (const Face& face : modelData.faces) {
-                // Alterna cores para melhor visualização
-                static int colorToggle = 0;
-                if (colorToggle % 2 == 0) {
-                    glColor3f(0.8f, 0.6f, 0.2f);  // Laranja
-                } else {
-                    glColor3f(0.2f, 0.6f, 0.8f);  // Azul
-                }
-                colorToggle++;
-                
-                // Desenha o triângulo usando os índices de vértices
-                const Vertex& v1 = modelData.vertices[face.v1];
-                const Vertex& v2 = modelData.vertices[face.v2];
-                const Vertex& v3 = modelData.vertices[face.v3];
-                
-                glVertex3f(v1.x, v1.y, v1.z);
-                glVertex3f(v2.x, v2.y, v2.z);
-                glVertex3f(v3.x, v3.y, v3.z);
-            }
-            glEnd();
-        } else {
-            // Fallback: renderiza vértices diretamente em grupos de 3 (triângulos)
-            glBegin(GL_TRIANGLES);
-            for (size_t i = 0; i < modelData.vertices.size(); i += 3) {
-                if (i + 2 < modelData.vertices.size()) {
-                    // Alterna cores para melhor visualização
-                    static int colorToggle = 0;
-                    if (colorToggle % 2 == 0) {
-                        glColor3f(0.8f, 0.6f, 0.2f);  // Laranja
-                    } else {
-                        glColor3f(0.2f, 0.6f, 0.8f);  // Azul
-                    }
-                    colorToggle++;
-                    
-                    // Desenha o triângulo
-                    const Vertex& v1 = modelData.vertices[i];
-                    const Vertex& v2 = modelData.vertices[i + 1];
-                    const Vertex& v3 = modelData.vertices[i + 2];
-                    
-                    glVertex3f(v1.x, v1.y, v1.z);
-                    glVertex3f(v2.x, v2.y, v2.z);
-                    glVertex3f(v3.x, v3.y, v3.z);
-                }
-            }
-            glEnd();
-        }
+    // Renderiza os lotes estáticos e a restante hierarquia da cena
+    if (staticBatchesReady) {
+        drawStaticBatches();
     }
+    drawGroups(glutGet(GLUT_ELAPSED_TIME) / 1000.0f);
     
     // Troca os buffers (double buffering) para exibir a cena renderizada
     glutSwapBuffers();
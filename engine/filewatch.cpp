@@ -0,0 +1,116 @@
+#include "filewatch.h"
+#include <filesystem>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+
+// Separa um caminho na pasta e no nome do ficheiro. A pasta é canónica: o
+// inotify devolve o mesmo descritor para a mesma pasta escrita de formas
+// diferentes (ex.: "." e o caminho absoluto), que têm de ter a mesma chave
+static void splitPath(const string& path, string& directory, string& name) {
+    size_t slash = path.find_last_of('/');
+    if (slash == string::npos) {
+        directory = ".";
+        name = path;
+    } else {
+        directory = slash == 0 ? "/" : path.substr(0, slash);
+        name = path.substr(slash + 1);
+    }
+
+    error_code error;
+    fs::path canonical = fs::weakly_canonical(directory, error);
+    if (!error) {
+        directory = canonical.string();
+    }
+}
+
+FileWatcher::FileWatcher() : fd(-1) {
+#ifdef __linux__
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        cerr << "Aviso: inotify indisponível, os ficheiros não serão observados" << endl;
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+}
+
+void FileWatcher::setFiles(const vector<string>& paths) {
+    files.clear();
+    if (fd < 0) {
+        return;
+    }
+
+#ifdef __linux__
+    set<string> wanted;
+    for (const string& path : paths) {
+        string directory, name;
+        splitPath(path, directory, name);
+        files[directory + "/" + name] = path;
+        wanted.insert(directory);
+    }
+
+    // Remove as pastas que já não têm ficheiros observados
+    for (auto it = directories.begin(); it != directories.end();) {
+        if (wanted.count(it->second) == 0) {
+            inotify_rm_watch(fd, it->first);
+            it = directories.erase(it);
+        } else {
+            wanted.erase(it->second);
+            ++it;
+        }
+    }
+
+    // Adiciona as novas
+    for (const string& directory : wanted) {
+        int wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) {
+            cerr << "Aviso: não foi possível observar a pasta: " << directory << endl;
+            continue;
+        }
+        directories[wd] = directory;
+    }
+#endif
+}
+
+set<string> FileWatcher::poll() {
+    set<string> changed;
+    if (fd < 0) {
+        return changed;
+    }
+
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+        for (char* p = buffer; p < buffer + length;) {
+            const inotify_event* event = (const inotify_event*)p;
+            p += sizeof(inotify_event) + event->len;
+
+            auto directory = directories.find(event->wd);
+            if (directory == directories.end() || event->len == 0) {
+                continue;
+            }
+
+            auto file = files.find(directory->second + "/" + event->name);
+            if (file != files.end()) {
+                changed.insert(file->second);
+            }
+        }
+    }
+#endif
+    return changed;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @class FileWatcher
+ * @brief Observa um conjunto de ficheiros com inotify e indica quais mudaram.
+ *
+ * São observadas as pastas dos ficheiros (e não os ficheiros), porque os
+ * editores costumam gravar num ficheiro temporário e renomeá-lo, o que
+ * invalida uma observação feita sobre o ficheiro original.
+ *
+ * Em sistemas sem inotify isAvailable() devolve false e poll() nunca indica mudanças.
+ */
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /// true se o inotify foi inicializado
+    bool isAvailable() const { return fd >= 0; }
+
+    /**
+     * @brief Substitui o conjunto de ficheiros observados.
+     *
+     * @param files Caminhos tal como aparecem na cena (são devolvidos assim por poll())
+     */
+    void setFiles(const std::vector<std::string>& files);
+
+    /**
+     * @brief Lê os eventos pendentes sem bloquear.
+     *
+     * @return Ficheiros observados que foram escritos ou substituídos
+     */
+    std::set<std::string> poll();
+
+private:
+    int fd;                                      ///< Descritor do inotify, ou -1
+    std::map<int, std::string> directories;      ///< Descritor da observação -> pasta
+    std::map<std::string, std::string> files;    ///< "pasta/nome" -> caminho original
+};
@@ -0,0 +1,117 @@
+#include "jobpool.h"
+
+using namespace std;
+
+
+JobPool::JobPool(unsigned int threads) {
+    for (unsigned int i = 1; i < threads; i++) {
+        workers.emplace_back(&JobPool::workerLoop, this);
+    }
+}
+
+JobPool::~JobPool() {
+    {
+        lock_guard<mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void JobPool::run(size_t jobCount, const function<void(size_t)>& jobs) {
+    // Um só trabalho (ou nenhuma thread extra): não vale a pena acordar ninguém
+    if (workers.empty() || jobCount <= 1) {
+        for (size_t i = 0; i < jobCount; i++) {
+            jobs(i);
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(stateMutex);
+        job = &jobs;
+        count = jobCount;
+        next.store(0, memory_order_relaxed);
+        busy = (unsigned int)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    work();
+
+    unique_lock<mutex> lock(stateMutex);
+    done.wait(lock, [this] { return busy == 0; });
+    job = nullptr;
+}
+
+void JobPool::work() {
+    for (size_t i = next.fetch_add(1, memory_order_relaxed); i < count; i = next.fetch_add(1, memory_order_relaxed)) {
+        (*job)(i);
+    }
+}
+
+void JobPool::workerLoop() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(stateMutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+        work();
+
+        lock_guard<mutex> lock(stateMutex);
+        if (--busy == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+
+AsyncTask::AsyncTask() {
+    // Só depois de inicializados os restantes membros
+    worker = thread(&AsyncTask::workerLoop, this);
+}
+
+AsyncTask::~AsyncTask() {
+    {
+        lock_guard<mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void AsyncTask::start(function<void()> job) {
+    {
+        lock_guard<mutex> lock(stateMutex);
+        task = move(job);
+        running = true;
+    }
+    wake.notify_one();
+}
+
+void AsyncTask::wait() {
+    unique_lock<mutex> lock(stateMutex);
+    done.wait(lock, [this] { return !running; });
+}
+
+void AsyncTask::workerLoop() {
+    unique_lock<mutex> lock(stateMutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || running; });
+        if (stopping && !running) {
+            return;
+        }
+        // A tarefa corre sem o mutex, para que wait() possa esperar por ela
+        lock.unlock();
+        task();
+        lock.lock();
+        running = false;
+        done.notify_all();
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class JobPool
+ * @brief Threads permanentes que executam em paralelo os trabalhos de cada frame.
+ *
+ * run() distribui os índices 0..count-1 pelas threads, que os retiram com um
+ * contador atómico. A thread que chama run() também trabalha e só regressa
+ * quando todos os trabalhos terminaram. Entre chamadas, as threads esperam
+ * numa variável de condição, pelo que não são criadas threads por frame.
+ */
+class JobPool {
+public:
+    /**
+     * @param threads Número total de threads, incluindo a que chama run()
+     */
+    explicit JobPool(unsigned int threads);
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    /// Número total de threads, incluindo a que chama run()
+    unsigned int size() const { return (unsigned int)workers.size() + 1; }
+
+    /**
+     * @brief Executa jobs(0) .. jobs(jobCount - 1) em paralelo e espera que terminem.
+     *
+     * Só pode ser chamada por uma thread de cada vez.
+     */
+    void run(size_t jobCount, const std::function<void(size_t)>& jobs);
+
+private:
+    void workerLoop();
+    void work();
+
+    std::vector<std::thread> workers;
+    std::mutex stateMutex;                            ///< Protege job, count, busy, generation e stopping
+    std::condition_variable wake;                     ///< Nova geração de trabalhos ou fim
+    std::condition_variable done;                     ///< A última thread terminou a geração
+    const std::function<void(size_t)>* job = nullptr; ///< Trabalhos da geração atual
+    size_t count = 0;
+    std::atomic<size_t> next{0};                      ///< Próximo índice a atribuir
+    unsigned int busy = 0;                            ///< Threads ainda na geração atual
+    uint64_t generation = 0;
+    bool stopping = false;
+};
+
+/**
+ * @class AsyncTask
+ * @brief Thread permanente que executa uma tarefa de cada vez em segundo plano.
+ *
+ * A tarefa pode usar um JobPool, desde que a thread que chamou start() não
+ * o use até wait() regressar.
+ */
+class AsyncTask {
+public:
+    AsyncTask();
+    ~AsyncTask();
+
+    AsyncTask(const AsyncTask&) = delete;
+    AsyncTask& operator=(const AsyncTask&) = delete;
+
+    /// Começa a executar job; a tarefa anterior tem de ter terminado (wait())
+    void start(std::function<void()> job);
+
+    /// Espera que a tarefa em curso termine; regressa logo se não houver nenhuma
+    void wait();
+
+private:
+    void workerLoop();
+
+    std::thread worker;
+    std::mutex stateMutex;                            ///< Protege task, running e stopping
+    std::condition_variable wake;                     ///< Nova tarefa ou fim
+    std::condition_variable done;                     ///< A tarefa terminou
+    std::function<void()> task;                       ///< Tarefa em curso
+    bool running = false;
+    bool stopping = false;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <utility>
+
+/**
+ * @class LoadQueue
+ * @brief Fila sem locks com vários produtores e um único consumidor.
+ *
+ * Os produtores (threads de carregamento) inserem com compare-and-swap numa
+ * pilha atómica. O consumidor (thread de renderização) retira a pilha inteira
+ * de uma vez com exchange e inverte-a, pelo que os elementos saem pela ordem
+ * em que foram inseridos.
+ */
+template <typename T>
+class LoadQueue {
+public:
+    LoadQueue() : head(nullptr), pending(nullptr) {}
+
+    ~LoadQueue() {
+        T discarded;
+        while (pop(discarded)) {}
+    }
+
+    LoadQueue(const LoadQueue&) = delete;
+    LoadQueue& operator=(const LoadQueue&) = delete;
+
+    /// Insere um elemento (pode ser chamado de qualquer thread)
+    void push(T value) {
+        Node* node = new Node{std::move(value), head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                           std::memory_order_relaxed)) {}
+    }
+
+    /**
+     * @brief Retira o elemento mais antigo (só a thread consumidora).
+     *
+     * @return false se a fila estiver vazia
+     */
+    bool pop(T& value) {
+        if (!pending) {
+            // Inverte a pilha: o elemento mais antigo fica à cabeça
+            Node* list = head.exchange(nullptr, std::memory_order_acquire);
+            while (list) {
+                Node* next = list->next;
+                list->next = pending;
+                pending = list;
+                list = next;
+            }
+        }
+        if (!pending) {
+            return false;
+        }
+
+        Node* node = pending;
+        pending = node->next;
+        value = std::move(node->value);
+        delete node;
+        return true;
+    }
+
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    std::atomic<Node*> head;  ///< Pilha partilhada com os produtores
+    Node* pending;            ///< Elementos já retirados da pilha, por ordem (só o consumidor)
+};
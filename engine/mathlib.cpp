@@ -0,0 +1,321 @@
+#include "mathlib.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+// SSE2 existe sempre nestes processadores; o AVX é detetado em tempo de execução
+#define MATH_SIMD_X86
+#include <immintrin.h>
+#define MATH_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+using namespace std;
+
+/// Graus para radianos
+const float DEGREES_TO_RADIANS = 3.14159265358979f / 180.0f;
+
+
+mat4 mat4::identity() {
+    mat4 r = {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+    return r;
+}
+
+mat4 mat4::translation(float x, float y, float z) {
+    mat4 r = identity();
+    r.m[12] = x;
+    r.m[13] = y;
+    r.m[14] = z;
+    return r;
+}
+
+mat4 mat4::scaling(float x, float y, float z) {
+    mat4 r = identity();
+    r.m[0] = x;
+    r.m[5] = y;
+    r.m[10] = z;
+    return r;
+}
+
+mat4 mat4::rotation(float angle, float x, float y, float z) {
+    return quat::axisAngle(angle, vec3{x, y, z}).toMatrix();
+}
+
+mat4 mat4::basis(vec3 x, vec3 y, vec3 z, vec3 origin) {
+    mat4 r = {{x.x, x.y, x.z, 0, y.x, y.y, y.z, 0, z.x, z.y, z.z, 0, origin.x, origin.y, origin.z, 1}};
+    return r;
+}
+
+mat4 mat4::lookAt(vec3 eye, vec3 center, vec3 up) {
+    // Eixos da câmera: s para a direita, u para cima, -f para trás
+    vec3 f = normalize(center - eye);
+    vec3 s = normalize(cross(f, up));
+    vec3 u = cross(s, f);
+    mat4 r = {{s.x, u.x, -f.x, 0, s.y, u.y, -f.y, 0, s.z, u.z, -f.z, 0,
+               -dot(s, eye), -dot(u, eye), dot(f, eye), 1}};
+    return r;
+}
+
+mat4 mat4::perspective(float fov, float aspect, float near, float far) {
+    // Parâmetros degenerados: o GLU deixa a matriz como está
+    float half = fov * DEGREES_TO_RADIANS / 2;
+    if (far == near || sinf(half) == 0 || aspect == 0) {
+        return identity();
+    }
+    float f = cosf(half) / sinf(half);
+    mat4 r = {{f / aspect, 0, 0, 0, 0, f, 0, 0, 0, 0, (far + near) / (near - far), -1,
+               0, 0, 2 * far * near / (near - far), 0}};
+    return r;
+}
+
+quat quat::axisAngle(float angle, vec3 axis) {
+    float l = length(axis);
+    if (l == 0) {
+        return identity();
+    }
+    float half = angle * DEGREES_TO_RADIANS / 2;
+    float s = sinf(half) / l;
+    return quat{axis.x * s, axis.y * s, axis.z * s, cosf(half)};
+}
+
+mat4 quat::toMatrix() const {
+    float xx = x * x, yy = y * y, zz = z * z;
+    float xy = x * y, xz = x * z, yz = y * z;
+    float wx = w * x, wy = w * y, wz = w * z;
+    mat4 r = {{1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0,
+               2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0,
+               2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0,
+               0, 0, 0, 1}};
+    return r;
+}
+
+quat operator*(quat a, quat b) {
+    return quat{a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+}
+
+Frustum Frustum::fromMatrix(const mat4& matrix) {
+    // Linha i da matriz: m[i], m[4 + i], m[8 + i], m[12 + i]
+    const float* m = matrix.m;
+    Frustum frustum;
+    for (int i = 0; i < 3; i++) {
+        for (int side = 0; side < 2; side++) {
+            float sign = side == 0 ? 1.0f : -1.0f;
+            frustum.planes[2 * i + side] = vec4{m[3] + sign * m[i], m[7] + sign * m[4 + i],
+                                                m[11] + sign * m[8 + i], m[15] + sign * m[12 + i]};
+        }
+    }
+    return frustum;
+}
+
+bool Frustum::excludes(const float bounds[6]) const {
+    for (const vec4& plane : planes) {
+        // Canto da caixa mais para dentro do plano
+        float x = plane.x >= 0 ? bounds[3] : bounds[0];
+        float y = plane.y >= 0 ? bounds[4] : bounds[1];
+        float z = plane.z >= 0 ? bounds[5] : bounds[2];
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Todos os núcleos somam pela mesma ordem, ((c0 x + c1 y) + c2 z) + c3 w, e
+// sem FMA: os resultados são iguais com qualquer nível de instruções
+
+#ifdef MATH_SIMD_X86
+
+mat4 operator*(const mat4& a, const mat4& b) {
+    __m128 a0 = _mm_load_ps(a.m), a1 = _mm_load_ps(a.m + 4), a2 = _mm_load_ps(a.m + 8), a3 = _mm_load_ps(a.m + 12);
+    mat4 r;
+    for (int j = 0; j < 4; j++) {
+        const float* column = b.m + 4 * j;
+        __m128 sum = _mm_add_ps(_mm_mul_ps(a0, _mm_set1_ps(column[0])), _mm_mul_ps(a1, _mm_set1_ps(column[1])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_set1_ps(column[2])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a3, _mm_set1_ps(column[3])));
+        _mm_store_ps(r.m + 4 * j, sum);
+    }
+    return r;
+}
+
+vec4 operator*(const mat4& a, const vec4& v) {
+    __m128 sum = _mm_add_ps(_mm_mul_ps(_mm_load_ps(a.m), _mm_set1_ps(v.x)), _mm_mul_ps(_mm_load_ps(a.m + 4), _mm_set1_ps(v.y)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(a.m + 8), _mm_set1_ps(v.z)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(a.m + 12), _mm_set1_ps(v.w)));
+    vec4 r;
+    _mm_store_ps(&r.x, sum);
+    return r;
+}
+
+// Escreve só x, y, z: o ponto seguinte (ou o fim do vetor) fica intacto
+static inline void store3(float* out, __m128 v) {
+    _mm_storel_pi((__m64*)out, v);
+    _mm_store_ss(out + 2, _mm_movehl_ps(v, v));
+}
+
+static void transformPointsSSE2(const mat4& matrix, const float* points, float* out, size_t count) {
+    __m128 c0 = _mm_load_ps(matrix.m), c1 = _mm_load_ps(matrix.m + 4);
+    __m128 c2 = _mm_load_ps(matrix.m + 8), c3 = _mm_load_ps(matrix.m + 12);
+    for (size_t i = 0; i < count; i++) {
+        const float* p = points + 3 * i;
+        __m128 sum = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(p[0])), _mm_mul_ps(c1, _mm_set1_ps(p[1])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(p[2])));
+        store3(out + 3 * i, _mm_add_ps(sum, c3));
+    }
+}
+
+static void propagateMatricesSSE2(const mat4& root, const uint32_t* parents, const mat4* locals, mat4* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = (parents[i] == UINT32_MAX ? root : out[parents[i]]) * locals[i];
+    }
+}
+
+// Dois pontos por iteração, um em cada metade do registo de 256 bits
+MATH_TARGET_AVX static void transformPointsAVX(const mat4& matrix, const float* points, float* out, size_t count) {
+    __m256 c0 = _mm256_broadcast_ps((const __m128*)matrix.m), c1 = _mm256_broadcast_ps((const __m128*)(matrix.m + 4));
+    __m256 c2 = _mm256_broadcast_ps((const __m128*)(matrix.m + 8)), c3 = _mm256_broadcast_ps((const __m128*)(matrix.m + 12));
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const float* p = points + 3 * i;
+        __m256 x = _mm256_set_m128(_mm_set1_ps(p[3]), _mm_set1_ps(p[0]));
+        __m256 y = _mm256_set_m128(_mm_set1_ps(p[4]), _mm_set1_ps(p[1]));
+        __m256 z = _mm256_set_m128(_mm_set1_ps(p[5]), _mm_set1_ps(p[2]));
+        __m256 sum = _mm256_add_ps(_mm256_mul_ps(c0, x), _mm256_mul_ps(c1, y));
+        sum = _mm256_add_ps(_mm256_add_ps(sum, _mm256_mul_ps(c2, z)), c3);
+        store3(out + 3 * i, _mm256_castps256_ps128(sum));
+        store3(out + 3 * i + 3, _mm256_extractf128_ps(sum, 1));
+    }
+    if (i < count) {
+        transformPointsSSE2(matrix, points + 3 * i, out + 3 * i, count - i);
+    }
+}
+
+// Duas colunas do resultado por iteração
+MATH_TARGET_AVX static inline void multiplyAVX(const mat4& a, const mat4& b, mat4& r) {
+    __m256 a0 = _mm256_broadcast_ps((const __m128*)a.m), a1 = _mm256_broadcast_ps((const __m128*)(a.m + 4));
+    __m256 a2 = _mm256_broadcast_ps((const __m128*)(a.m + 8)), a3 = _mm256_broadcast_ps((const __m128*)(a.m + 12));
+    for (int j = 0; j < 4; j += 2) {
+        __m256 columns = _mm256_loadu_ps(b.m + 4 * j);
+        __m256 sum = _mm256_add_ps(_mm256_mul_ps(a0, _mm256_permute_ps(columns, 0x00)),
+                                   _mm256_mul_ps(a1, _mm256_permute_ps(columns, 0x55)));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(a2, _mm256_permute_ps(columns, 0xAA)));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(a3, _mm256_permute_ps(columns, 0xFF)));
+        _mm256_storeu_ps(r.m + 4 * j, sum);
+    }
+}
+
+MATH_TARGET_AVX static void propagateMatricesAVX(const mat4& root, const uint32_t* parents, const mat4* locals, mat4* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        multiplyAVX(parents[i] == UINT32_MAX ? root : out[parents[i]], locals[i], out[i]);
+    }
+}
+
+void transformBounds(const mat4& matrix, const float bounds[6], float out[6]) {
+    // Centro transformado e meia-extensão pelos valores absolutos da parte 3x3
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 center = _mm_load_ps(matrix.m + 12);
+    __m128 extent = _mm_setzero_ps();
+    for (int k = 0; k < 3; k++) {
+        __m128 column = _mm_load_ps(matrix.m + 4 * k);
+        __m128 c = _mm_mul_ps(_mm_set1_ps(bounds[k] + bounds[3 + k]), half);
+        __m128 e = _mm_mul_ps(_mm_set1_ps(bounds[3 + k] - bounds[k]), half);
+        center = _mm_add_ps(center, _mm_mul_ps(column, c));
+        extent = _mm_add_ps(extent, _mm_mul_ps(_mm_and_ps(column, absMask), e));
+    }
+    store3(out, _mm_sub_ps(center, extent));
+    store3(out + 3, _mm_add_ps(center, extent));
+}
+
+#else
+
+mat4 operator*(const mat4& a, const mat4& b) {
+    mat4 r;
+    for (int j = 0; j < 4; j++) {
+        for (int k = 0; k < 4; k++) {
+            r.m[4 * j + k] = ((a.m[k] * b.m[4 * j] + a.m[4 + k] * b.m[4 * j + 1]) + a.m[8 + k] * b.m[4 * j + 2]) +
+                             a.m[12 + k] * b.m[4 * j + 3];
+        }
+    }
+    return r;
+}
+
+vec4 operator*(const mat4& a, const vec4& v) {
+    float r[4];
+    for (int k = 0; k < 4; k++) {
+        r[k] = ((a.m[k] * v.x + a.m[4 + k] * v.y) + a.m[8 + k] * v.z) + a.m[12 + k] * v.w;
+    }
+    return vec4{r[0], r[1], r[2], r[3]};
+}
+
+void transformBounds(const mat4& matrix, const float bounds[6], float out[6]) {
+    for (int k = 0; k < 3; k++) {
+        float center = matrix.m[12 + k], extent = 0;
+        for (int j = 0; j < 3; j++) {
+            center += matrix.m[4 * j + k] * ((bounds[j] + bounds[3 + j]) * 0.5f);
+            extent += fabsf(matrix.m[4 * j + k]) * ((bounds[3 + j] - bounds[j]) * 0.5f);
+        }
+        out[k] = center - extent;
+        out[3 + k] = center + extent;
+    }
+}
+
+static void transformPointsScalar(const mat4& matrix, const float* points, float* out, size_t count) {
+    const float* m = matrix.m;
+    for (size_t i = 0; i < count; i++) {
+        float x = points[3 * i], y = points[3 * i + 1], z = points[3 * i + 2];
+        for (int k = 0; k < 3; k++) {
+            out[3 * i + k] = ((m[k] * x + m[4 + k] * y) + m[8 + k] * z) + m[12 + k];
+        }
+    }
+}
+
+static void propagateMatricesScalar(const mat4& root, const uint32_t* parents, const mat4* locals, mat4* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = (parents[i] == UINT32_MAX ? root : out[parents[i]]) * locals[i];
+    }
+}
+
+#endif  // MATH_SIMD_X86
+
+
+/**
+ * @struct MathKernels
+ * @brief Núcleos em lote escolhidos para o processador.
+ */
+struct MathKernels {
+    void (*transformPoints)(const mat4&, const float*, float*, size_t);
+    void (*propagateMatrices)(const mat4&, const uint32_t*, const mat4*, mat4*, size_t);
+    const char* level;
+};
+
+static MathKernels selectMathKernels() {
+#ifdef MATH_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) {
+        return MathKernels{transformPointsAVX, propagateMatricesAVX, "avx"};
+    }
+    return MathKernels{transformPointsSSE2, propagateMatricesSSE2, "sse2"};
+#else
+    return MathKernels{transformPointsScalar, propagateMatricesScalar, "scalar"};
+#endif
+}
+
+// Escolhidos na primeira utilização
+static const MathKernels& mathKernels() {
+    static const MathKernels kernels = selectMathKernels();
+    return kernels;
+}
+
+void transformPoints(const mat4& matrix, const float* points, float* out, size_t count) {
+    mathKernels().transformPoints(matrix, points, out, count);
+}
+
+void propagateMatrices(const mat4& root, const uint32_t* parents, const mat4* locals, mat4* out, size_t count) {
+    mathKernels().propagateMatrices(root, parents, locals, out, count);
+}
+
+const char* mathSimdLevel() {
+    return mathKernels().level;
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct vec3
+ * @brief Vetor ou ponto 3D.
+ */
+struct vec3 {
+    float x, y, z;
+};
+
+inline vec3 operator+(vec3 a, vec3 b) { return vec3{a.x + b.x, a.y + b.y, a.z + b.z}; }
+inline vec3 operator-(vec3 a, vec3 b) { return vec3{a.x - b.x, a.y - b.y, a.z - b.z}; }
+inline vec3 operator*(vec3 a, float s) { return vec3{a.x * s, a.y * s, a.z * s}; }
+inline float dot(vec3 a, vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline vec3 cross(vec3 a, vec3 b) { return vec3{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+inline float length(vec3 a) { return sqrtf(dot(a, a)); }
+
+/// Vetor unitário com a direção de a; o vetor nulo mantém-se nulo
+inline vec3 normalize(vec3 a) {
+    float l = length(a);
+    return l > 0 ? a * (1 / l) : a;
+}
+
+/**
+ * @struct vec4
+ * @brief Vetor homogéneo, alinhado para as instruções SIMD.
+ */
+struct alignas(16) vec4 {
+    float x, y, z, w;
+};
+
+/**
+ * @struct mat4
+ * @brief Matriz 4x4 por colunas, como no OpenGL (glLoadMatrixf aceita m diretamente).
+ *
+ * As funções de construção reproduzem as do OpenGL e do GLU, pelo que
+ * a * b corresponde a carregar a e chamar glMultMatrixf(b).
+ */
+struct alignas(16) mat4 {
+    float m[16];   ///< Coluna j nas posições 4j..4j+3; m[12..14] é a translação
+
+    static mat4 identity();
+    /// Como glTranslatef
+    static mat4 translation(float x, float y, float z);
+    /// Como glScalef
+    static mat4 scaling(float x, float y, float z);
+    /// Como glRotatef: angle graus em torno de (x, y, z); eixo nulo dá a identidade
+    static mat4 rotation(float angle, float x, float y, float z);
+    /// Matriz com os eixos x, y, z nas colunas e a origem na translação
+    static mat4 basis(vec3 x, vec3 y, vec3 z, vec3 origin);
+    /// Como gluLookAt
+    static mat4 lookAt(vec3 eye, vec3 center, vec3 up);
+    /// Como gluPerspective (fov vertical em graus)
+    static mat4 perspective(float fov, float aspect, float near, float far);
+};
+
+/// Produto de matrizes (SSE)
+mat4 operator*(const mat4& a, const mat4& b);
+
+/// Produto de uma matriz por um vetor (SSE)
+vec4 operator*(const mat4& a, const vec4& v);
+
+/**
+ * @struct quat
+ * @brief Quaternião unitário de rotação.
+ */
+struct quat {
+    float x, y, z, w;
+
+    static quat identity() { return quat{0, 0, 0, 1}; }
+    /// Rotação de angle graus em torno do eixo (normalizado internamente)
+    static quat axisAngle(float angle, vec3 axis);
+    /// Matriz de rotação equivalente
+    mat4 toMatrix() const;
+};
+
+/// Composição de rotações: a * b aplica primeiro b e depois a
+quat operator*(quat a, quat b);
+
+/**
+ * @brief Transforma pontos (w = 1) por uma matriz.
+ *
+ * @param matrix Matriz a aplicar
+ * @param points x, y, z de cada ponto
+ * @param out x, y, z de cada ponto transformado; pode ser igual a points
+ * @param count Número de pontos
+ */
+void transformPoints(const mat4& matrix, const float* points, float* out, size_t count);
+
+/**
+ * @brief Matrizes globais de uma hierarquia em pré-ordem: out[i] = out[parents[i]] * locals[i].
+ *
+ * @param root Matriz dos nós sem pai (por exemplo a matriz de visualização)
+ * @param parents Pai de cada nó, anterior a ele, ou UINT32_MAX para os nós de topo
+ * @param locals Matriz local de cada nó
+ * @param out Matriz global de cada nó
+ * @param count Número de nós
+ */
+void propagateMatrices(const mat4& root, const uint32_t* parents, const mat4* locals, mat4* out, size_t count);
+
+/**
+ * @brief AABB que contém uma AABB transformada (método de Arvo).
+ *
+ * @param matrix Matriz afim
+ * @param bounds Mínimo x, y, z seguido do máximo x, y, z
+ * @param out AABB transformada, no mesmo formato
+ */
+void transformBounds(const mat4& matrix, const float bounds[6], float out[6]);
+
+/**
+ * @struct Frustum
+ * @brief Planos do volume de visualização, para excluir caixas fora da vista.
+ */
+struct Frustum {
+    vec4 planes[6];   ///< (a, b, c, d) com ax + by + cz + d >= 0 do lado de dentro
+
+    /// Planos de uma matriz de projeção (método de Gribb e Hartmann), no espaço a que a matriz se aplica
+    static Frustum fromMatrix(const mat4& matrix);
+    /// true se a AABB (mínimo x, y, z e máximo x, y, z) está toda fora de algum plano
+    bool excludes(const float bounds[6]) const;
+};
+
+/**
+ * @brief Instruções usadas pelos núcleos em lote: "avx", "sse2" ou "scalar".
+ *
+ * São escolhidas na primeira utilização, conforme o processador.
+ */
+const char* mathSimdLevel();
@@ -0,0 +1,329 @@
+#include "modelcache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/// Versão do formato; entradas de outra versão são ignoradas
+const uint32_t MODEL_CACHE_VERSION = 1;
+/// Tamanho do cabeçalho (múltiplo de 16 para os dados ficarem alinhados)
+const size_t MODEL_CACHE_HEADER_SIZE = 64;
+
+
+bool MappedFile::open(const string& path, bool copyOnWrite) {
+    close();
+
+#ifdef _WIN32
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    length = (size_t)file.tellg();
+    bytes = new unsigned char[length + 1];
+    bytes[length] = 0;
+    file.seekg(0);
+    if (!file.read((char*)bytes, length)) {
+        close();
+        return false;
+    }
+    (void)copyOnWrite;
+    return true;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = (size_t)info.st_size;
+
+    void* address;
+    size_t reserved = size;
+    if (!copyOnWrite) {
+        address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    } else {
+        // O resto da última página do ficheiro já é zero; se o ficheiro ocupar
+        // páginas inteiras, o nulo fica numa página anónima reservada a seguir
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        reserved = size / page * page + page;
+        address = mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address != MAP_FAILED &&
+            mmap(address, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            munmap(address, reserved);
+            address = MAP_FAILED;
+        }
+    }
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+
+    bytes = (unsigned char*)address;
+    length = size;
+    mappedLength = reserved;
+    mapped = true;
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+    if (bytes) {
+#ifndef _WIN32
+        if (mapped) {
+            munmap(bytes, mappedLength);
+        }
+#endif
+        if (!mapped) {
+            delete[] bytes;
+        }
+    }
+    bytes = nullptr;
+    length = 0;
+    mappedLength = 0;
+    mapped = false;
+}
+
+void MappedFile::prefaultForWrite() {
+#if defined(MADV_POPULATE_WRITE)
+    if (mapped && length > 0) {
+        madvise(bytes, length, MADV_POPULATE_WRITE);
+    }
+#endif
+}
+
+// Constantes do XXH64
+const uint64_t PRIME64_1 = 11400714785074694791ULL;
+const uint64_t PRIME64_2 = 14029467366897019727ULL;
+const uint64_t PRIME64_3 = 1609587929392839497ULL;
+const uint64_t PRIME64_4 = 9650029242287828579ULL;
+const uint64_t PRIME64_5 = 2870177450012600261ULL;
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const unsigned char* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint32_t read32(const unsigned char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t xxhRound(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static inline uint64_t xxhMerge(uint64_t acc, uint64_t value) {
+    acc ^= xxhRound(0, value);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+uint64_t hashContent(const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    const unsigned char* end = p + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        // 4 acumuladores independentes: o processador executa as 4 rondas em paralelo
+        uint64_t v1 = PRIME64_1 + PRIME64_2;
+        uint64_t v2 = PRIME64_2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - PRIME64_1;
+
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = xxhRound(v1, read64(p));
+            v2 = xxhRound(v2, read64(p + 8));
+            v3 = xxhRound(v3, read64(p + 16));
+            v4 = xxhRound(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        hash = xxhMerge(hash, v1);
+        hash = xxhMerge(hash, v2);
+        hash = xxhMerge(hash, v3);
+        hash = xxhMerge(hash, v4);
+    } else {
+        hash = PRIME64_5;
+    }
+
+    hash += (uint64_t)size;
+
+    for (; p + 8 <= end; p += 8) {
+        hash ^= xxhRound(0, read64(p));
+        hash = rotl64(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        hash ^= (uint64_t)read32(p) * PRIME64_1;
+        hash = rotl64(hash, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        hash ^= (*p) * PRIME64_5;
+        hash = rotl64(hash, 11) * PRIME64_1;
+    }
+
+    // Avalanche final
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+string modelCachePath(const string& cacheDir, const string& filename) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.3dm",
+             (unsigned long long)hashContent(filename.data(), filename.size()));
+    return cacheDir + "/" + name;
+}
+
+bool openModelCache(const string& path, uint64_t contentHash, uint64_t sourceSize, CachedModel& model) {
+    if (!model.file.open(path)) {
+        return false;
+    }
+
+    const unsigned char* data = model.file.data();
+    size_t size = model.file.size();
+
+    uint32_t version, vertexCount, indexCount;
+    uint64_t hash, source;
+    if (size < MODEL_CACHE_HEADER_SIZE || memcmp(data, MODEL_CACHE_MAGIC, 4) != 0) {
+        model.file.close();
+        return false;
+    }
+    memcpy(&version, data + 4, 4);
+    memcpy(&hash, data + 8, 8);
+    memcpy(&source, data + 16, 8);
+    memcpy(&vertexCount, data + 24, 4);
+    memcpy(&indexCount, data + 28, 4);
+
+    uint64_t expected = MODEL_CACHE_HEADER_SIZE + (uint64_t)vertexCount * 3 * sizeof(float) +
+                        (uint64_t)indexCount * sizeof(uint32_t);
+    if (version != MODEL_CACHE_VERSION || hash != contentHash || source != sourceSize ||
+        expected != size || indexCount % 3 != 0) {
+        model.file.close();
+        return false;
+    }
+
+    // Os índices são copiados para as faces sem mais verificações: uma entrada
+    // corrompida é tratada como falta na cache e o modelo é lido de novo
+    const uint32_t* indices = (const uint32_t*)(data + MODEL_CACHE_HEADER_SIZE + (size_t)vertexCount * 3 * sizeof(float));
+    for (uint32_t i = 0; i < indexCount; i++) {
+        if (indices[i] >= vertexCount) {
+            model.file.close();
+            return false;
+        }
+    }
+
+    model.vertexCount = vertexCount;
+    model.indexCount = indexCount;
+    memcpy(model.bounds, data + 32, sizeof(model.bounds));
+    model.vertices = (const float*)(data + MODEL_CACHE_HEADER_SIZE);
+    model.indices = indices;
+    return true;
+}
+
+bool readModelCacheBounds(const string& path, float bounds[6]) {
+    ifstream file(path, ios::binary);
+    unsigned char header[MODEL_CACHE_HEADER_SIZE];
+    if (!file.is_open() || !file.read((char*)header, sizeof(header)) ||
+        memcmp(header, MODEL_CACHE_MAGIC, 4) != 0) {
+        return false;
+    }
+    memcpy(bounds, header + 32, 6 * sizeof(float));
+    return true;
+}
+
+// Cria a pasta da cache (ignora o erro se já existir)
+static void createDirectory(const string& dir) {
+#ifdef _WIN32
+    _mkdir(dir.c_str());
+#else
+    mkdir(dir.c_str(), 0755);
+#endif
+}
+
+bool writeModelCache(const string& path, uint64_t contentHash, uint64_t sourceSize,
+                     const float* vertices, uint32_t vertexCount,
+                     const uint32_t* indices, uint32_t indexCount) {
+    size_t slash = path.find_last_of('/');
+    if (slash != string::npos) {
+        createDirectory(path.substr(0, slash));
+    }
+
+    unsigned char header[MODEL_CACHE_HEADER_SIZE] = {};
+    float bounds[6] = {0, 0, 0, 0, 0, 0};
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        for (int k = 0; k < 3; k++) {
+            float value = vertices[3 * v + k];
+            if (v == 0 || value < bounds[k]) bounds[k] = value;
+            if (v == 0 || value > bounds[3 + k]) bounds[3 + k] = value;
+        }
+    }
+
+    memcpy(header, MODEL_CACHE_MAGIC, 4);
+    memcpy(header + 4, &MODEL_CACHE_VERSION, 4);
+    memcpy(header + 8, &contentHash, 8);
+    memcpy(header + 16, &sourceSize, 8);
+    memcpy(header + 24, &vertexCount, 4);
+    memcpy(header + 28, &indexCount, 4);
+    memcpy(header + 32, bounds, sizeof(bounds));
+
+    // Nome único por processo e thread: vários carregadores (ou vários
+    // executáveis) podem escrever a mesma entrada ao mesmo tempo
+    string temporary = path + ".tmp." + to_string(getpid()) + "."
+        + to_string(hash<thread::id>()(this_thread::get_id()));
+    {
+        ofstream file(temporary, ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write((const char*)header, sizeof(header));
+        file.write((const char*)vertices, (streamsize)vertexCount * 3 * sizeof(float));
+        file.write((const char*)indices, (streamsize)indexCount * sizeof(uint32_t));
+        if (!file) {
+            file.close();
+            remove(temporary.c_str());
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    remove(path.c_str());
+#endif
+    if (rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
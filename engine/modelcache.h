@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Identificador no início de um ficheiro da cache de modelos
+const char MODEL_CACHE_MAGIC[4] = {'3', 'D', 'M', '1'};
+
+/**
+ * @class MappedFile
+ * @brief Ficheiro mapeado em memória (mmap), só de leitura ou em cópia privada.
+ *
+ * Em sistemas sem mmap o conteúdo é lido para um buffer.
+ */
+class MappedFile {
+public:
+    MappedFile() : bytes(nullptr), length(0), mappedLength(0), mapped(false) {}
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Mapeia o ficheiro indicado, libertando o mapeamento anterior.
+     *
+     * @param copyOnWrite Mapeamento privado com escrita (MAP_PRIVATE): as escritas
+     *        não chegam ao ficheiro e só as páginas escritas são copiadas. Há um
+     *        byte nulo depois do fim, como XMLDocument::ParseInPlace precisa.
+     * @return false se o ficheiro não existir ou não puder ser lido
+     */
+    bool open(const std::string& path, bool copyOnWrite = false);
+
+    /// Liberta o mapeamento
+    void close();
+
+    const unsigned char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+    /// Conteúdo com escrita (só para ficheiros abertos com copyOnWrite)
+    char* writableData() { return (char*)bytes; }
+
+    /**
+     * @brief Copia já todas as páginas de um mapeamento copyOnWrite que vai ser escrito.
+     *
+     * Uma cópia em bloco (MADV_POPULATE_WRITE) em vez de uma falta de página
+     * por cada página escrita. Sem efeito em sistemas que não a suportem.
+     */
+    void prefaultForWrite();
+
+private:
+    unsigned char* bytes;
+    size_t length;
+    size_t mappedLength;  ///< Tamanho do mapeamento (pode incluir uma página extra)
+    bool mapped;  ///< true se bytes vem de mmap, false se foi alocado
+};
+
+/**
+ * @struct CachedModel
+ * @brief Vista sobre um ficheiro da cache: os ponteiros apontam para o mapeamento.
+ */
+struct CachedModel {
+    MappedFile file;                   ///< Mapeamento do ficheiro da cache
+    const float* vertices = nullptr;   ///< x, y, z de cada vértice
+    const uint32_t* indices = nullptr; ///< 3 índices por triângulo
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    float bounds[6] = {0, 0, 0, 0, 0, 0}; ///< AABB: mínimo x, y, z seguido do máximo x, y, z
+};
+
+/**
+ * @brief Hash de 64 bits do conteúdo de um ficheiro (algoritmo XXH64).
+ *
+ * Processa 32 bytes por iteração em 4 acumuladores independentes,
+ * pelo que corre a vários GB/s e é muito mais rápido do que o parse XML.
+ */
+uint64_t hashContent(const void* data, size_t size);
+
+/**
+ * @brief Caminho do ficheiro da cache de um modelo.
+ *
+ * O nome deriva do caminho do modelo, pelo que cada modelo tem uma única
+ * entrada e uma versão desatualizada é substituída em vez de acumulada.
+ *
+ * @param cacheDir Pasta da cache
+ * @param filename Caminho do ficheiro .3d
+ */
+std::string modelCachePath(const std::string& cacheDir, const std::string& filename);
+
+/**
+ * @brief Mapeia uma entrada da cache e valida-a contra o ficheiro de origem.
+ *
+ * Estrutura (little-endian, 64 bytes de cabeçalho):
+ * - "3DM1", versão (uint32), hash e tamanho do ficheiro de origem (uint64)
+ * - número de vértices e de índices (uint32), AABB (6 floats), 8 bytes livres
+ * - vértices (3 floats cada) seguidos dos índices (uint32)
+ *
+ * @param path Caminho da entrada (modelCachePath)
+ * @param contentHash Hash do ficheiro de origem (hashContent)
+ * @param sourceSize Tamanho do ficheiro de origem em bytes
+ * @param model Recebe o mapeamento e os ponteiros para os dados
+ *
+ * @return false se a entrada não existir, for de outra versão do ficheiro, estiver
+ *         truncada ou tiver índices fora dos vértices
+ */
+bool openModelCache(const std::string& path, uint64_t contentHash, uint64_t sourceSize, CachedModel& model);
+
+/**
+ * @brief Lê só a AABB do cabeçalho de uma entrada da cache, sem a validar.
+ *
+ * Serve para desenhar uma caixa provisória enquanto o modelo carrega.
+ *
+ * @return false se a entrada não existir
+ */
+bool readModelCacheBounds(const std::string& path, float bounds[6]);
+
+/**
+ * @brief Escreve uma entrada da cache.
+ *
+ * O ficheiro é escrito com outro nome e depois renomeado, para que outro
+ * processo nunca mapeie uma entrada incompleta. A pasta é criada se não existir.
+ *
+ * @return true se a entrada foi escrita
+ */
+bool writeModelCache(const std::string& path, uint64_t contentHash, uint64_t sourceSize,
+                     const float* vertices, uint32_t vertexCount,
+                     const uint32_t* indices, uint32_t indexCount);
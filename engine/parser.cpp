@@ -1,56 +1,336 @@
 #include "parser.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <unordered_map>
+#include <utility>
 
 using namespace std;
 using namespace tinyxml2;
+namespace fs = std::filesystem;
+
+
+/**
+ * @struct PathResolver
+ * @brief Resolve os caminhos referidos por uma cena para a forma guardada em Scene::strings.
+ *
+ * Cada caminho distinto do XML é resolvido uma única vez: as cenas repetem o
+ * mesmo ficheiro em muitos modelos e a resolução consulta o sistema de ficheiros.
+ */
+struct PathResolver {
+    fs::path sceneDir;                            ///< Pasta canónica do arquivo XML
+    fs::path currentDir;                          ///< Pasta atual, canónica
+    unordered_map<string, uint32_t> resolved;     ///< Caminho tal como está no XML -> índice em Scene::strings
+    string lookup;                                ///< Chave reutilizada por resolve()
+
+    explicit PathResolver(const string& sceneFile) {
+        error_code error;
+        currentDir = fs::weakly_canonical(fs::current_path(error), error);
+        sceneDir = fs::weakly_canonical(fs::absolute(sceneFile, error), error).parent_path();
+    }
+
+    // Caminho canónico, relativo à pasta atual, do ficheiro path da cena
+    uint32_t resolve(Scene& scene, const char* path) {
+        lookup.assign(path);
+        auto found = resolved.find(lookup);
+        if (found != resolved.end()) {
+            return found->second;
+        }
+
+        error_code error;
+        fs::path original(lookup);
+        fs::path candidate = sceneDir / original;
+        if (!fs::exists(candidate, error) && fs::exists(original, error)) {
+            candidate = currentDir / original;
+        }
+        fs::path canonical = fs::weakly_canonical(candidate, error);
+        if (error) {
+            canonical = candidate.lexically_normal();
+        }
+
+        uint32_t index = scene.intern(canonical.lexically_proximate(currentDir).string().c_str());
+        resolved.emplace(lookup, index);
+        return index;
+    }
+};
+
+
+// Avança até ao fim do elemento cujo START_ELEMENT acabou de ser lido, ignorando o conteúdo
+static void skipElement(XMLPullParser& parser) {
+    int depth = parser.Depth();
+    XMLPullParser::Event event;
+    while ((event = parser.Next()) != XMLPullParser::END_DOCUMENT && event != XMLPullParser::PARSE_ERROR) {
+        if (event == XMLPullParser::END_ELEMENT && parser.Depth() == depth) {
+            return;
+        }
+    }
+}
+
+// Avança até ao próximo filho do elemento atual: true no START_ELEMENT do filho,
+// false no fim do elemento (ou em caso de erro). Cada filho devolvido tem de ser
+// consumido até ao fim (por exemplo com skipElement) antes da chamada seguinte
+static bool nextChild(XMLPullParser& parser) {
+    for (;;) {
+        XMLPullParser::Event event = parser.Next();
+        if (event == XMLPullParser::START_ELEMENT) {
+            return true;
+        }
+        if (event != XMLPullParser::TEXT) {
+            return false;
+        }
+    }
+}
+
+
+// Texto que identifica a geometria de uma figura procedural: o nome e os
+// parâmetros ordenados pelo nome (a ordem dos atributos no XML não conta)
+static uint32_t proceduralKey(Scene& scene, SceneModel& model) {
+    SceneParam* first = scene.params.data() + model.firstParam;
+    sort(first, first + model.paramCount, [&scene](const SceneParam& a, const SceneParam& b) {
+        return scene.strings[a.name] < scene.strings[b.name];
+    });
+
+    static string key;
+    key.assign("procedural:");
+    key += scene.strings[model.procedural];
+    for (uint32_t p = 0; p < model.paramCount; p++) {
+        char value[32];
+        snprintf(value, sizeof(value), "=%.9g", first[p].value);
+        key += ' ';
+        key += scene.strings[first[p].name];
+        key += value;
+    }
+    return scene.intern(key.c_str());
+}
+
+
+// Liga cada <use> ao grupo com o id referido (guardado em instance, como
+// índice em Scene::strings, durante o parse) e desfaz os ciclos: um protótipo
+// que, direta ou indiretamente, se usa a si próprio seria desenhado sem fim
+static void resolveReferences(Scene& scene, const vector<uint32_t>& uses, const vector<uint32_t>& groupById) {
+    for (uint32_t use : uses) {
+        uint32_t ref = scene.groups[use].instance;
+        scene.groups[use].instance = ref < groupById.size() ? groupById[ref] : NO_INDEX;
+        if (scene.groups[use].instance == NO_INDEX) {
+            cerr << "Aviso: <use> de um grupo inexistente ignorado: " << scene.strings[ref] << endl;
+        }
+    }
+
+    // Pesquisa em profundidade, sem recursão, pelos <use> de cada protótipo
+    enum : uint8_t { UNVISITED, VISITING, DONE };
+    vector<uint8_t> state(scene.groups.size(), UNVISITED);
+    struct Visit {
+        uint32_t prototype;
+        uint32_t next;      // Próximo grupo da subárvore a examinar
+    };
+    vector<Visit> stack;
+
+    for (uint32_t use : uses) {
+        uint32_t root = scene.groups[use].instance;
+        if (root == NO_INDEX || state[root] == DONE) {
+            continue;
+        }
+        state[root] = VISITING;
+        stack.push_back(Visit{root, root});
+
+        while (!stack.empty()) {
+            Visit& visit = stack.back();
+            if (visit.next == scene.groups[visit.prototype].end) {
+                state[visit.prototype] = DONE;
+                stack.pop_back();
+                continue;
+            }
+
+            SceneGroup& group = scene.groups[visit.next++];
+            if (group.instance == NO_INDEX || state[group.instance] == DONE) {
+                continue;
+            }
+            if (state[group.instance] == VISITING) {
+                cerr << "Aviso: <use> que forma um ciclo ignorado" << endl;
+                group.instance = NO_INDEX;
+                continue;
+            }
+            state[group.instance] = VISITING;
+            stack.push_back(Visit{group.instance, group.instance});
+        }
+    }
+}
+
+
+// Lê <color>: componentes R, G, B entre 0 e 255 e o brilho
+static void parseColor(XMLPullParser& parser, Material& color) {
+    static const char* const rgb[] = {"R", "G", "B"};
+    while (nextChild(parser)) {
+        float* component = nullptr;
+        if (strcmp(parser.Name(), "diffuse") == 0) {
+            component = color.diffuse;
+        } else if (strcmp(parser.Name(), "ambient") == 0) {
+            component = color.ambient;
+        } else if (strcmp(parser.Name(), "specular") == 0) {
+            component = color.specular;
+        } else if (strcmp(parser.Name(), "emissive") == 0) {
+            component = color.emissive;
+        } else if (strcmp(parser.Name(), "shininess") == 0) {
+            parser.QueryFloatAttribute("value", &color.shininess);
+        }
+        
+        if (component) {
+            float values[3] = {component[0] * 255, component[1] * 255, component[2] * 255};
+            parser.QueryFloatAttributes(rgb, 3, values);
+            for (int k = 0; k < 3; k++) {
+                component[k] = values[k] / 255;
+            }
+        }
+        skipElement(parser);
+    }
+}
 
 
 bool SimpleParser::parseXMLFile(const std::string& filename, 
                                Window& window, 
                                Camera& camera, 
-                               Group& group) {
-    // Carrega o arquivo XML em memória
-    XMLDocument doc;
-    if (doc.LoadFile(filename.c_str()) != XML_SUCCESS) {
+                               Scene& scene) {
+    // Lê o arquivo XML aos blocos, sem construir o documento: a memória usada
+    // não depende do tamanho da cena
+    XMLPullParser parser;
+    if (parser.Open(filename.c_str()) != XML_SUCCESS) {
         cerr << "Erro ao carregar arquivo XML: " << filename << endl;
         return false;
     }
+    scene.clear();
+    PathResolver paths(filename);
+
+    // Grupos abertos, desde <world> (groups[0]) até ao atual. Cada grupo só
+    // usa o primeiro <transform> e o primeiro <models>, tal como <world> só
+    // usa o primeiro elemento de cada tipo; um <use> só tem <transform>
+    struct OpenGroup {
+        uint32_t index;
+        bool hasTransform;
+        bool hasModels;
+        bool reference;
+    };
+    vector<OpenGroup> open;
+    
+    // Grupos com id (índice em Scene::strings -> grupo) e os <use> a ligar no fim
+    vector<uint32_t> groupById;
+    vector<uint32_t> uses;
+    
+    bool foundWorld = false;
+    bool foundWindow = false;
+    bool foundCamera = false;
+    bool foundLights = false;
+    XMLPullParser::Event event;
+    while ((event = parser.Next()) != XMLPullParser::END_DOCUMENT && event != XMLPullParser::PARSE_ERROR) {
+        if (event != XMLPullParser::START_ELEMENT) {
+            continue;
+        }
+        if (foundWorld || strcmp(parser.Name(), "world") != 0) {
+            skipElement(parser);
+            continue;
+        }
+        foundWorld = true;
+        scene.groups.push_back(SceneGroup{NO_INDEX, 0, 0, 0, 0, 0, NO_INDEX});
+        open.push_back(OpenGroup{0, true, true, false});
+
+        while (!open.empty()) {
+            if (!nextChild(parser)) {
+                // Fim do grupo atual: os descendentes já estão todos em scene.groups
+                scene.groups[open.back().index].end = (uint32_t)scene.groups.size();
+                open.pop_back();
+                continue;
+            }
+            
+            OpenGroup& current = open.back();
+            const char* name = parser.Name();
+            if (current.reference && strcmp(name, "transform") != 0) {
+                skipElement(parser);
+            } else if (strcmp(name, "group") == 0 || strcmp(name, "use") == 0) {
+                uint32_t index = (uint32_t)scene.groups.size();
+                bool reference = name[0] == 'u';
+                const char* id = parser.Attribute(reference ? "ref" : "id");
+                uint32_t key = id ? scene.intern(id) : NO_INDEX;
+                if (reference && !id) {
+                    cerr << "Aviso: elemento <use> sem atributo 'ref'" << endl;
+                }
+                
+                // Um <use> guarda o id referido até resolveReferences
+                scene.groups.push_back(SceneGroup{current.index, 0, (uint32_t)scene.transforms.size(), 0,
+                                                  (uint32_t)scene.models.size(), 0, NO_INDEX});
+                open.push_back(OpenGroup{index, false, reference, reference});
+                if (reference && id) {
+                    scene.groups[index].instance = key;
+                    uses.push_back(index);
+                } else if (id) {
+                    if (key >= groupById.size()) {
+                        groupById.resize(scene.strings.size(), NO_INDEX);
+                    }
+                    if (groupById[key] == NO_INDEX) {
+                        groupById[key] = index;
+                    } else {
+                        cerr << "Aviso: id de grupo repetido, usa-se o primeiro: " << id << endl;
+                    }
+                }
+            } else if (open.size() == 1 && !foundWindow && strcmp(name, "window") == 0) {
+                // Parse de janela
+                foundWindow = true;
+                parseWindow(&parser, window);
+            } else if (open.size() == 1 && !foundCamera && strcmp(name, "camera") == 0) {
+                // Parse de câmera
+                foundCamera = true;
+                parseCamera(&parser, camera);
+            } else if (open.size() == 1 && !foundLights && strcmp(name, "lights") == 0) {
+                foundLights = true;
+                parseLights(parser, scene);
+            } else if (!current.hasTransform && strcmp(name, "transform") == 0) {
+                current.hasTransform = true;
+                parseTransform(parser, scene, current.index);
+            } else if (!current.hasModels && strcmp(name, "models") == 0) {
+                current.hasModels = true;
+                parseModels(parser, scene, current.index, paths);
+            } else {
+                skipElement(parser);
+            }
+        }
+    }
 
-    // Obtém o elemento raiz <world>
-    XMLElement* worldElement = doc.FirstChildElement("world");
-    if (!worldElement) {
+    // O resto do arquivo também é validado
+    if (parser.Error()) {
+        cerr << "Erro ao carregar arquivo XML: " << filename
+             << " (linha " << parser.ErrorLineNum() << ")" << endl;
+        return false;
+    }
+    if (!foundWorld) {
         cerr << "Erro: elemento 'world' não encontrado no arquivo XML" << endl;
         return false;
     }
-
-    // Parse de janela
-    XMLElement* windowElement = worldElement->FirstChildElement("window");
-    parseWindow(windowElement, window);
-    
-    // Parse de câmera
-    XMLElement* cameraElement = worldElement->FirstChildElement("camera");
-    parseCamera(cameraElement, camera);
-
-    // Parse de grupo e modelos
-    XMLElement* groupElement = worldElement->FirstChildElement("group");
-    if (groupElement) {
-        XMLElement* modelsElement = groupElement->FirstChildElement("models");
-        if (modelsElement) {
-            parseModels(modelsElement, group);
-        } else {
-            cerr << "Aviso: elemento 'models' não encontrado no grupo" << endl;
-        }
-    } else {
+    resolveReferences(scene, uses, groupById);
+    if (!foundWindow) {
+        parseWindow(nullptr, window);
+    }
+    if (!foundCamera) {
+        parseCamera(nullptr, camera);
+    }
+    if (scene.groups.size() == 1) {
         cerr << "Aviso: elemento 'group' não encontrado" << endl;
     }
+    
+    if (scene.models.empty()) {
+        cerr << "Aviso: nenhum modelo encontrado no arquivo XML" << endl;
+    }
+    cout << "Cena: " << scene.groups.size() - 1 - uses.size() << " grupos, " << uses.size()
+         << " referências, " << scene.transforms.size()
+         << " transformações, " << scene.models.size() << " modelos (" << scene.assets.size()
+         << " distintos), " << scene.lights.size() << " luzes" << endl;
 
     return true;
 }
 
 
-void SimpleParser::parseWindow(XMLElement* windowElement, Window& window) {
+void SimpleParser::parseWindow(XMLPullParser* parser, Window& window) {
     // Se o elemento não existir, mantém valores padrão
-    if (!windowElement) {
+    if (!parser) {
         cerr << "Aviso: elemento 'window' não encontrado, usando padrão (800x600)" << endl;
         return;
     }
@@ -59,8 +339,9 @@ void SimpleParser::parseWindow(XMLElement* windowElement, Window& window) {
     int width = window.width;
     int height = window.height;
     
-    windowElement->QueryIntAttribute("width", &width);
-    windowElement->QueryIntAttribute("height", &height);
+    parser->QueryIntAttribute("width", &width);
+    parser->QueryIntAttribute("height", &height);
+    skipElement(*parser);
     
     // Valida dimensões (mínimo 100x100)
     if (width < 100 || height < 100) {
@@ -75,51 +356,47 @@ void SimpleParser::parseWindow(XMLElement* windowElement, Window& window) {
 }
 
 
-void SimpleParser::parseCamera(XMLElement* cameraElement, Camera& camera) {
+void SimpleParser::parseCamera(XMLPullParser* parser, Camera& camera) {
     // Se o elemento câmera não existir, usa valores padrão da câmera
-    if (!cameraElement) {
+    if (!parser) {
         cerr << "Aviso: elemento 'camera' não encontrado, usando câmera padrão" << endl;
         return;
     }
 
-    // Valores padrão para posição
+    // Valores padrão para posição, ponto de interesse, vetor "para cima" e projeção
     float posX = 0, posY = 0, posZ = 5;
-    XMLElement* positionElement = cameraElement->FirstChildElement("position");
-    if (positionElement) {
-        positionElement->QueryFloatAttribute("x", &posX);
-        positionElement->QueryFloatAttribute("y", &posY);
-        positionElement->QueryFloatAttribute("z", &posZ);
-        cout << "Posição câmera: (" << posX << ", " << posY << ", " << posZ << ")" << endl;
-    }
-
-    // Valores padrão para ponto de interesse
     float lookX = 0, lookY = 0, lookZ = 0;
-    XMLElement* lookAtElement = cameraElement->FirstChildElement("lookAt");
-    if (lookAtElement) {
-        lookAtElement->QueryFloatAttribute("x", &lookX);
-        lookAtElement->QueryFloatAttribute("y", &lookY);
-        lookAtElement->QueryFloatAttribute("z", &lookZ);
-        cout << "LookAt câmera: (" << lookX << ", " << lookY << ", " << lookZ << ")" << endl;
-    }
-
-    // Valores padrão para vetor "para cima"
     float upX = 0, upY = 1, upZ = 0;
-    XMLElement* upElement = cameraElement->FirstChildElement("up");
-    if (upElement) {
-        upElement->QueryFloatAttribute("x", &upX);
-        upElement->QueryFloatAttribute("y", &upY);
-        upElement->QueryFloatAttribute("z", &upZ);
-        cout << "Vetor 'up' câmera: (" << upX << ", " << upY << ", " << upZ << ")" << endl;
-    }
-
-    // Valores padrão para projeção
     float fov = 60, near = 1, far = 1000;
-    XMLElement* projectionElement = cameraElement->FirstChildElement("projection");
-    if (projectionElement) {
-        projectionElement->QueryFloatAttribute("fov", &fov);
-        projectionElement->QueryFloatAttribute("near", &near);
-        projectionElement->QueryFloatAttribute("far", &far);
-        cout << "Projeção câmera - FOV: " << fov << "°, Near: " << near << ", Far: " << far << endl;
+    bool foundPosition = false, foundLookAt = false, foundUp = false, foundProjection = false;
+
+    while (nextChild(*parser)) {
+        if (!foundPosition && strcmp(parser->Name(), "position") == 0) {
+            foundPosition = true;
+            parser->QueryFloatAttribute("x", &posX);
+            parser->QueryFloatAttribute("y", &posY);
+            parser->QueryFloatAttribute("z", &posZ);
+            cout << "Posição câmera: (" << posX << ", " << posY << ", " << posZ << ")" << endl;
+        } else if (!foundLookAt && strcmp(parser->Name(), "lookAt") == 0) {
+            foundLookAt = true;
+            parser->QueryFloatAttribute("x", &lookX);
+            parser->QueryFloatAttribute("y", &lookY);
+            parser->QueryFloatAttribute("z", &lookZ);
+            cout << "LookAt câmera: (" << lookX << ", " << lookY << ", " << lookZ << ")" << endl;
+        } else if (!foundUp && strcmp(parser->Name(), "up") == 0) {
+            foundUp = true;
+            parser->QueryFloatAttribute("x", &upX);
+            parser->QueryFloatAttribute("y", &upY);
+            parser->QueryFloatAttribute("z", &upZ);
+            cout << "Vetor 'up' câmera: (" << upX << ", " << upY << ", " << upZ << ")" << endl;
+        } else if (!foundProjection && strcmp(parser->Name(), "projection") == 0) {
+            foundProjection = true;
+            parser->QueryFloatAttribute("fov", &fov);
+            parser->QueryFloatAttribute("near", &near);
+            parser->QueryFloatAttribute("far", &far);
+            cout << "Projeção câmera - FOV: " << fov << "°, Near: " << near << ", Far: " << far << endl;
+        }
+        skipElement(*parser);
     }
 
     // Aplica todas as configurações à câmera
@@ -130,42 +407,163 @@ void SimpleParser::parseCamera(XMLElement* cameraElement, Camera& camera) {
 }
 
 
-void SimpleParser::parseModels(XMLElement* modelsElement, Group& group) {
-    // Valida entrada
-    if (!modelsElement) {
-        cerr << "Erro: elemento 'models' inválido" << endl;
-        return;
+void SimpleParser::parseTransform(XMLPullParser& parser, Scene& scene, uint32_t group) {
+    static const char* const xyz[] = {"x", "y", "z"};
+    scene.groups[group].firstTransform = (uint32_t)scene.transforms.size();
+    
+    while (nextChild(parser)) {
+        // Os atributos são lidos antes de avançar para os filhos
+        Transform transform = {};
+        const char* name = parser.Name();
+        bool timed = parser.QueryFloatAttribute("time", &transform.time) == XML_SUCCESS;
+        
+        if (strcmp(name, "translate") == 0 && timed) {
+            // Curva de Catmull-Rom pelos pontos de controlo
+            transform.type = TransformType::TimedTranslate;
+            const char* align = parser.Attribute("align");
+            XMLUtil::ToBool(align ? align : "false", &transform.align);
+            
+            transform.firstPoint = (uint32_t)(scene.points.size() / 3);
+            while (nextChild(parser)) {
+                if (strcmp(parser.Name(), "point") == 0) {
+                    float point[3] = {0, 0, 0};
+                    parser.QueryFloatAttributes(xyz, 3, point);
+                    scene.points.insert(scene.points.end(), point, point + 3);
+                }
+                skipElement(parser);
+            }
+            transform.pointCount = (uint32_t)(scene.points.size() / 3) - transform.firstPoint;
+            
+            if (transform.pointCount < 4 || transform.time <= 0) {
+                cerr << "Aviso: translação temporizada com menos de 4 pontos ou tempo inválido, ignorada" << endl;
+                scene.points.resize((size_t)transform.firstPoint * 3);
+                continue;
+            }
+            scene.transforms.push_back(transform);
+            continue;
+        }
+        
+        if (strcmp(name, "translate") == 0) {
+            transform.type = TransformType::Translate;
+            parser.QueryFloatAttributes(xyz, 3, transform.xyz);
+        } else if (strcmp(name, "rotate") == 0) {
+            transform.type = timed ? TransformType::TimedRotate : TransformType::Rotate;
+            parser.QueryFloatAttributes(xyz, 3, transform.xyz);
+            parser.QueryFloatAttribute("angle", &transform.angle);
+            if (timed && transform.time <= 0) {
+                cerr << "Aviso: rotação temporizada com tempo inválido, ignorada" << endl;
+                skipElement(parser);
+                continue;
+            }
+        } else if (strcmp(name, "scale") == 0) {
+            transform.type = TransformType::Scale;
+            transform.xyz[0] = transform.xyz[1] = transform.xyz[2] = 1;
+            parser.QueryFloatAttributes(xyz, 3, transform.xyz);
+        } else {
+            skipElement(parser);
+            continue;
+        }
+        
+        scene.transforms.push_back(transform);
+        skipElement(parser);
     }
     
-    // Limpa lista anterior de modelos
-    group.models.clear();
+    scene.groups[group].transformCount = (uint32_t)scene.transforms.size() - scene.groups[group].firstTransform;
+}
+
+
+void SimpleParser::parseModels(XMLPullParser& parser, Scene& scene, uint32_t group, PathResolver& paths) {
+    scene.groups[group].firstModel = (uint32_t)scene.models.size();
     
     // Itera sobre todos os elementos <model>
-    XMLElement* modelElement = modelsElement->FirstChildElement("model");
-    int modelCount = 0;
-    
-    while (modelElement) {
-        // Extrai o atributo "file" de cada modelo
-        const char* filename = modelElement->Attribute("file");
+    while (nextChild(parser)) {
+        if (strcmp(parser.Name(), "model") != 0) {
+            skipElement(parser);
+            continue;
+        }
         
-        if (filename) {
-            Model model;
-            model.filename = std::string(filename);
-            group.models.push_back(model);
-            
-            cout << "Modelo encontrado: " << model.filename << endl;
-            modelCount++;
-        } else {
-            cerr << "Aviso: elemento <model> sem atributo 'file'" << endl;
+        // Extrai o atributo "file" (ou "procedural") de cada modelo
+        const char* filename = parser.Attribute("file");
+        const char* procedural = parser.Attribute("procedural");
+        if (!procedural && !filename) {
+            cerr << "Aviso: elemento <model> sem atributo 'file' ou 'procedural'" << endl;
+            skipElement(parser);
+            continue;
+        }
+        
+        SceneModel model = {};
+        model.group = group;
+        model.file = procedural ? NO_INDEX : paths.resolve(scene, filename);
+        model.procedural = procedural ? scene.intern(procedural) : NO_INDEX;
+        model.firstParam = (uint32_t)scene.params.size();
+        model.texture = NO_INDEX;
+        
+        if (procedural) {
+            // Os restantes atributos numéricos são os parâmetros da figura
+            for (int i = 0; i < parser.AttributeCount(); i++) {
+                float value;
+                if (XMLUtil::ToFloat(parser.AttributeValue(i), &value)) {
+                    scene.params.push_back(SceneParam{scene.intern(parser.AttributeName(i)), value});
+                }
+            }
+        }
+        model.paramCount = (uint32_t)scene.params.size() - model.firstParam;
+        
+        // Modelos com o mesmo ficheiro ou a mesma figura partilham a geometria
+        uint32_t key = procedural ? proceduralKey(scene, model) : model.file;
+        model.asset = scene.internAsset(key, (uint32_t)scene.models.size());
+        
+        // Textura e cores
+        while (nextChild(parser)) {
+            if (model.texture == NO_INDEX && strcmp(parser.Name(), "texture") == 0) {
+                const char* texture = parser.Attribute("file");
+                if (texture) {
+                    model.texture = paths.resolve(scene, texture);
+                }
+                skipElement(parser);
+            } else if (!model.hasColor && strcmp(parser.Name(), "color") == 0) {
+                model.hasColor = true;
+                parseColor(parser, model.color);
+            } else {
+                skipElement(parser);
+            }
         }
         
-        // Próximo elemento <model>
-        modelElement = modelElement->NextSiblingElement("model");
+        scene.models.push_back(model);
     }
     
-    if (modelCount == 0) {
-        cerr << "Aviso: nenhum modelo encontrado no arquivo XML" << endl;
-    } else {
-        cout << "Total de modelos a carregar: " << modelCount << endl;
+    scene.groups[group].modelCount = (uint32_t)scene.models.size() - scene.groups[group].firstModel;
+}
+
+
+void SimpleParser::parseLights(XMLPullParser& parser, Scene& scene) {
+    static const char* const position[] = {"posx", "posy", "posz"};
+    static const char* const direction[] = {"dirx", "diry", "dirz"};
+    
+    while (nextChild(parser)) {
+        if (strcmp(parser.Name(), "light") != 0) {
+            skipElement(parser);
+            continue;
+        }
+        
+        Light light = {LightType::Point, {0, 0, 0}, {0, 1, 0}, 45};
+        const char* type = parser.Attribute("type");
+        if (type && strcmp(type, "point") == 0) {
+            light.type = LightType::Point;
+        } else if (type && strcmp(type, "directional") == 0) {
+            light.type = LightType::Directional;
+        } else if (type && strcmp(type, "spot") == 0) {
+            light.type = LightType::Spot;
+        } else {
+            cerr << "Aviso: luz de tipo desconhecido ignorada: " << (type ? type : "(sem tipo)") << endl;
+            skipElement(parser);
+            continue;
+        }
+        
+        parser.QueryFloatAttributes(position, 3, light.position);
+        parser.QueryFloatAttributes(direction, 3, light.direction);
+        parser.QueryFloatAttribute("cutoff", &light.cutoff);
+        scene.lights.push_back(light);
+        skipElement(parser);
     }
-}
\ No newline at end of file
+}
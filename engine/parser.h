@@ -1,8 +1,10 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <map>
 #include <fstream>
 #include "camera.h"
+#include "scene.h"
 #include "tinyxml2.h"
 
 /**
@@ -19,19 +21,23 @@ struct Window {
 
 /**
  * @struct Model
- * @brief Representa uma referência para um arquivo de modelo 3D.
+ * @brief Representa uma referência para um modelo 3D a carregar.
+ *
+ * O modelo é lido de um arquivo .3d ou, se o atributo procedural estiver
+ * presente, gerado em memória pela biblioteca do gerador:
+ * @code
+ * <model procedural="sphere" radius="1" slices="64" stacks="64" />
+ * @endcode
+ *
+ * É construído a partir de um SceneModel quando o modelo vai ser carregado.
  */
 struct Model {
-    std::string filename; ///< Caminho do arquivo .3d a carregar
+    std::string filename;                 ///< Caminho do arquivo .3d a carregar
+    std::string procedural;               ///< Figura a gerar (plane, box, sphere, cone, icosphere)
+    std::map<std::string, float> params;  ///< Parâmetros numéricos da figura procedural
 };
 
-/**
- * @struct Group
- * @brief Agrupa múltiplos modelos para a cena.
- */
-struct Group {
-    std::vector<Model> models; ///< Lista de modelos a renderizar
-};
+struct PathResolver;
 
 /**
  * @class SimpleParser
@@ -40,7 +46,8 @@ struct Group {
  * Esta classe oferece funcionalidades para ler arquivos XML que definem:
  * - Dimensões da janela
  * - Parâmetros da câmera (posição, orientação, projeção)
- * - Lista de modelos a carregar
+ * - Luzes
+ * - A hierarquia de grupos, com transformações e modelos
  *
  * O arquivo XML esperado segue a estrutura:
  * @code
@@ -52,14 +59,51 @@ struct Group {
  *     <up x="0" y="1" z="0" />
  *     <projection fov="60" near="1" far="1000" />
  *   </camera>
+ *   <lights>
+ *     <light type="point" posx="0" posy="10" posz="0" />
+ *   </lights>
  *   <group>
+ *     <transform>
+ *       <translate time="10" align="true">
+ *         <point x="0" y="0" z="4" />
+ *         ... (pelo menos 4 pontos)
+ *       </translate>
+ *       <rotate angle="90" x="0" y="1" z="0" />
+ *       <scale x="2" y="2" z="2" />
+ *     </transform>
  *     <models>
  *       <model file="plane.3d" />
- *       <model file="cone.3d" />
+ *       <model file="cone.3d">
+ *         <texture file="cone.jpg" />
+ *         <color>
+ *           <diffuse R="200" G="200" B="0" />
+ *         </color>
+ *       </model>
  *     </models>
+ *     <group> ... </group>
  *   </group>
+ *   <group id="lua">
+ *     ...
+ *   </group>
+ *   <use ref="lua">
+ *     <transform>
+ *       <translate x="5" y="0" z="0" />
+ *     </transform>
+ *   </use>
  * </world>
  * @endcode
+ *
+ * Um grupo com id é desenhado onde está definido e pode ser repetido com
+ * <use ref="...">, em qualquer ponto onde possa estar um <group> (antes ou
+ * depois da definição). O <use> só tem <transform>, aplicado antes das
+ * transformações do grupo referido; a subárvore do grupo é guardada uma
+ * única vez. Referências a ids inexistentes e ciclos são ignorados com um aviso.
+ *
+ * Os caminhos dos modelos e das texturas são relativos à pasta do arquivo
+ * XML. Se o ficheiro não existir aí mas existir a partir da pasta atual (como
+ * nas cenas antigas), é usado esse. Em Scene::strings ficam canónicos e
+ * relativos à pasta atual, pelo que "./a.3d" e "../pasta/a.3d" são o mesmo
+ * ficheiro se apontarem para o mesmo sítio.
  */
 class SimpleParser {
 public:
@@ -69,36 +113,59 @@ public:
      * Esta função lê o arquivo XML e extrai todos os parâmetros de:
      * - Window (dimensões)
      * - Camera (posição, orientação, projeção)
-     * - Group (modelos a carregar)
+     * - Scene (grupos, transformações, modelos e luzes)
      *
      * @param filename Caminho do arquivo XML de configuração
      * @param window Struct que será preenchida com dimensões da janela
      * @param camera Objeto câmera que será configurado com os parâmetros lidos
-     * @param group Struct que será preenchida com lista de modelos
+     * @param scene Cena que será substituída pela do arquivo
      *
      * @return true se o parse foi bem-sucedido, false caso contrário
      *
-     * @note O arquivo XML é lido uma única vez no início da aplicação,
-     *       conforme requerido pela Fase 1 do projeto.
+     * @note O arquivo é lido aos blocos com tinyxml2::XMLPullParser, sem
+     *       construir o documento; um erro em qualquer ponto do arquivo faz
+     *       o parse falhar. Os grupos são lidos sem recursão, pelo que a
+     *       profundidade da hierarquia não está limitada pela pilha.
      */
     static bool parseXMLFile(const std::string& filename, 
                             Window& window, 
                             Camera& camera, 
-                            Group& group);
+                            Scene& scene);
     
 private:
+    /**
+     * @brief Extrai as transformações de um grupo.
+     *
+     * As transformações ficam em Scene::transforms pela ordem do XML.
+     * Translações temporizadas com menos de 4 pontos são ignoradas.
+     *
+     * @param parser Parser no início do elemento <transform>; é avançado até ao fim dele
+     * @param scene Cena onde as transformações serão armazenadas
+     * @param group Índice do grupo em Scene::groups
+     */
+    static void parseTransform(tinyxml2::XMLPullParser& parser, Scene& scene, uint32_t group);
+    
     /**
      * @brief Extrai a lista de modelos do elemento XML de modelos.
      *
      * Percorre todos os elementos <model> dentro de <models> e
-     * adiciona cada um à lista do Group.
+     * acrescenta cada um (com textura e cores) a Scene::models, associado
+     * à sua geometria em Scene::assets.
      *
-     * @param modelsElement Ponteiro para o elemento XML <models>
-     * @param group Struct onde os modelos serão armazenados
+     * @param parser Parser no início do elemento <models>; é avançado até ao fim dele
+     * @param scene Cena onde os modelos serão armazenados
+     * @param group Índice do grupo em Scene::groups
+     * @param paths Resolução dos caminhos relativos à cena
+     */
+    static void parseModels(tinyxml2::XMLPullParser& parser, Scene& scene, uint32_t group, PathResolver& paths);
+    
+    /**
+     * @brief Extrai as luzes do elemento <lights>.
      *
-     * @note Esta função é chamada internamente por parseXMLFile()
+     * @param parser Parser no início do elemento <lights>; é avançado até ao fim dele
+     * @param scene Cena onde as luzes serão armazenadas
      */
-    static void parseModels(tinyxml2::XMLElement* modelsElement, Group& group);
+    static void parseLights(tinyxml2::XMLPullParser& parser, Scene& scene);
     
     /**
      * @brief Extrai os parâmetros de câmera do arquivo XML.
@@ -109,20 +176,22 @@ private:
      * - <up>
      * - <projection>
      *
-     * @param cameraElement Ponteiro para o elemento XML <camera>
+     * @param parser Parser no início do elemento <camera> (é avançado até ao
+     *               fim dele), ou nulo se o elemento não existir
      * @param camera Objeto câmera que será configurado
      *
      * @note Usa valores padrão se algum subelemento estiver ausente
      */
-    static void parseCamera(tinyxml2::XMLElement* cameraElement, Camera& camera);
+    static void parseCamera(tinyxml2::XMLPullParser* parser, Camera& camera);
     
     /**
      * @brief Extrai os parâmetros de janela do arquivo XML.
      *
-     * @param windowElement Ponteiro para o elemento XML <window>
+     * @param parser Parser no início do elemento <window> (é avançado até ao
+     *               fim dele), ou nulo se o elemento não existir
      * @param window Struct que será preenchida com width e height
      *
      * @note Se o elemento for nulo, mantém os valores padrão (800x600)
      */
-    static void parseWindow(tinyxml2::XMLElement* windowElement, Window& window);
+    static void parseWindow(tinyxml2::XMLPullParser* parser, Window& window);
 };
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "scene.h"
+#include <cmath>
+
+using namespace std;
+
+
+uint32_t Scene::intern(const char* text) {
+    // A chave é reutilizada: só há alocações quando o texto é novo
+    lookup.assign(text);
+    auto found = stringIndex.find(lookup);
+    if (found != stringIndex.end()) {
+        return found->second;
+    }
+
+    uint32_t index = (uint32_t)strings.size();
+    strings.push_back(lookup);
+    stringIndex.emplace(lookup, index);
+    return index;
+}
+
+uint32_t Scene::internAsset(uint32_t key, uint32_t model) {
+    if (key >= assetIndex.size()) {
+        assetIndex.resize(strings.size(), NO_INDEX);
+    }
+    if (assetIndex[key] == NO_INDEX) {
+        assetIndex[key] = (uint32_t)assets.size();
+        assets.push_back(model);
+    }
+    return assetIndex[key];
+}
+
+bool Scene::isAnimated() const {
+    for (const Transform& transform : transforms) {
+        if (transform.type == TransformType::TimedTranslate || transform.type == TransformType::TimedRotate) {
+            return true;
+        }
+    }
+    return false;
+}
+
+mat4 Scene::transformMatrix(const Transform& transform, float time) const {
+    const float* v = transform.xyz;
+    switch (transform.type) {
+        case TransformType::Translate:
+            return mat4::translation(v[0], v[1], v[2]);
+        
+        case TransformType::Rotate:
+            return mat4::rotation(transform.angle, v[0], v[1], v[2]);
+        
+        case TransformType::Scale:
+            return mat4::scaling(v[0], v[1], v[2]);
+        
+        case TransformType::TimedRotate:
+            return mat4::rotation(360.0f * fmodf(time, transform.time) / transform.time, v[0], v[1], v[2]);
+        
+        case TransformType::TimedTranslate: {
+            float position[3], tangent[3];
+            catmullRomPoint(points.data() + 3 * (size_t)transform.firstPoint, transform.pointCount,
+                            fmodf(time, transform.time) / transform.time, position, tangent);
+            vec3 origin = {position[0], position[1], position[2]};
+            if (!transform.align) {
+                return mat4::translation(origin.x, origin.y, origin.z);
+            }
+            
+            // Eixos do modelo: X pela tangente, Y o mais próximo possível de (0, 1, 0)
+            vec3 x = {tangent[0], tangent[1], tangent[2]};
+            vec3 z = cross(x, vec3{0, 1, 0});
+            if (length(x) < 1e-6f || length(z) < 1e-6f) {
+                return mat4::translation(origin.x, origin.y, origin.z);  // Tangente nula ou vertical
+            }
+            x = normalize(x);
+            z = normalize(z);
+            return mat4::basis(x, cross(z, x), z, origin);
+        }
+    }
+    return mat4::identity();
+}
+
+void Scene::clear() {
+    groups.clear();
+    transforms.clear();
+    points.clear();
+    models.clear();
+    params.clear();
+    lights.clear();
+    strings.clear();
+    assets.clear();
+    stringIndex.clear();
+    assetIndex.clear();
+}
+
+void catmullRomPoint(const float* points, uint32_t count, float t, float position[3], float derivative[3]) {
+    // Segmento da curva e posição local dentro dele
+    float global = (t - floorf(t)) * count;
+    uint32_t segment = (uint32_t)global;
+    if (segment >= count) {
+        segment = count - 1;
+    }
+    float local = global - segment;
+
+    const float* p[4];
+    for (uint32_t i = 0; i < 4; i++) {
+        p[i] = points + 3 * ((segment + count - 1 + i) % count);
+    }
+
+    // Pesos da matriz de Catmull-Rom (tensão 0.5) e das suas derivadas
+    float t2 = local * local, t3 = t2 * local;
+    float w[4] = {
+        -0.5f * t3 + t2 - 0.5f * local,
+        1.5f * t3 - 2.5f * t2 + 1.0f,
+        -1.5f * t3 + 2.0f * t2 + 0.5f * local,
+        0.5f * t3 - 0.5f * t2
+    };
+    float d[4] = {
+        -1.5f * t2 + 2.0f * local - 0.5f,
+        4.5f * t2 - 5.0f * local,
+        -4.5f * t2 + 4.0f * local + 0.5f,
+        1.5f * t2 - local
+    };
+
+    for (int k = 0; k < 3; k++) {
+        position[k] = w[0] * p[0][k] + w[1] * p[1][k] + w[2] * p[2][k] + w[3] * p[3][k];
+        derivative[k] = d[0] * p[0][k] + d[1] * p[1][k] + d[2] * p[2][k] + d[3] * p[3][k];
+    }
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mathlib.h"
+
+/// Índice inexistente (grupo sem pai, modelo sem textura, ...)
+const uint32_t NO_INDEX = 0xFFFFFFFF;
+
+/**
+ * @enum TransformType
+ * @brief Tipo de uma transformação de grupo.
+ */
+enum class TransformType : uint8_t {
+    Translate,       ///< Translação por xyz
+    Rotate,          ///< Rotação de angle graus em torno de xyz
+    Scale,           ///< Escala por xyz
+    TimedTranslate,  ///< Percurso numa curva de Catmull-Rom fechada em time segundos
+    TimedRotate      ///< Volta completa em torno de xyz em time segundos
+};
+
+/**
+ * @struct Transform
+ * @brief Transformação de um grupo, pela ordem em que aparece no XML.
+ */
+struct Transform {
+    TransformType type;
+    bool align;            ///< TimedTranslate: orienta o modelo pela tangente da curva
+    float xyz[3];          ///< Vetor da translação ou da escala, ou eixo da rotação
+    float angle;           ///< Rotate: ângulo em graus
+    float time;            ///< Transformações temporizadas: duração de uma volta (s)
+    uint32_t firstPoint;   ///< TimedTranslate: primeiro ponto de controlo em Scene::points
+    uint32_t pointCount;   ///< TimedTranslate: número de pontos (pelo menos 4)
+};
+
+/**
+ * @struct Material
+ * @brief Cores de um modelo (<color>), com componentes entre 0 e 1.
+ *
+ * Os valores padrão são os do enunciado: difusa (200, 200, 200) e ambiente
+ * (50, 50, 50) em 0..255, sem especular nem emissiva.
+ */
+struct Material {
+    float diffuse[3] = {200 / 255.0f, 200 / 255.0f, 200 / 255.0f};
+    float ambient[3] = {50 / 255.0f, 50 / 255.0f, 50 / 255.0f};
+    float specular[3] = {0, 0, 0};
+    float emissive[3] = {0, 0, 0};
+    float shininess = 0;
+};
+
+/**
+ * @struct SceneParam
+ * @brief Parâmetro numérico de um modelo procedural.
+ */
+struct SceneParam {
+    uint32_t name;         ///< Nome do atributo, em Scene::strings
+    float value;
+};
+
+/**
+ * @struct SceneModel
+ * @brief Modelo de um grupo: ficheiro ou figura procedural, textura e cores.
+ */
+struct SceneModel {
+    uint32_t group;        ///< Grupo a que pertence
+    uint32_t file;         ///< Caminho do ficheiro em Scene::strings, ou NO_INDEX se for procedural
+    uint32_t procedural;   ///< Nome da figura em Scene::strings, ou NO_INDEX
+    uint32_t firstParam;   ///< Primeiro parâmetro da figura em Scene::params
+    uint32_t paramCount;
+    uint32_t texture;      ///< Caminho da textura em Scene::strings, ou NO_INDEX
+    uint32_t asset;        ///< Geometria em Scene::assets (partilhada pelos modelos iguais)
+    bool hasColor;         ///< true se o modelo tem <color>
+    Material color;
+};
+
+/**
+ * @struct SceneGroup
+ * @brief Grupo da hierarquia da cena.
+ *
+ * Os grupos estão em pré-ordem em Scene::groups: os descendentes de um grupo
+ * ocupam as posições seguintes, até end. As transformações e os modelos de
+ * cada grupo são intervalos contíguos de Scene::transforms e Scene::models.
+ *
+ * Um <use ref="..."> é um grupo sem modelos nem filhos cujo instance é o
+ * grupo protótipo: depois das transformações do <use>, desenha-se a
+ * subárvore do protótipo, guardada uma única vez.
+ */
+struct SceneGroup {
+    uint32_t parent;           ///< Grupo pai, ou NO_INDEX na raiz
+    uint32_t end;              ///< Uma posição depois do último descendente
+    uint32_t firstTransform;
+    uint32_t transformCount;
+    uint32_t firstModel;
+    uint32_t modelCount;
+    uint32_t instance;         ///< <use>: grupo protótipo a desenhar aqui, ou NO_INDEX
+};
+
+/**
+ * @enum LightType
+ * @brief Tipo de uma luz.
+ */
+enum class LightType : uint8_t {
+    Point,
+    Directional,
+    Spot
+};
+
+/**
+ * @struct Light
+ * @brief Luz da cena (<lights>).
+ */
+struct Light {
+    LightType type;
+    float position[3];     ///< Point e Spot
+    float direction[3];    ///< Directional (direção para a luz) e Spot
+    float cutoff;          ///< Spot: ângulo de abertura em graus
+};
+
+/**
+ * @struct Scene
+ * @brief Hierarquia da cena em vetores contíguos ligados por índices.
+ *
+ * groups[0] é o elemento <world>; os grupos de topo são filhos dele. Os
+ * caminhos e os nomes são guardados uma única vez em strings (intern()) e
+ * referidos pelo índice. Os caminhos dos ficheiros são canónicos, pelo que
+ * o mesmo ficheiro tem sempre o mesmo índice.
+ *
+ * Os modelos com a mesma geometria (o mesmo ficheiro, ou a mesma figura com
+ * os mesmos parâmetros) partilham uma entrada de assets, que é carregada uma
+ * única vez.
+ */
+struct Scene {
+    std::vector<SceneGroup> groups;
+    std::vector<Transform> transforms;
+    std::vector<float> points;         ///< x, y, z dos pontos de controlo das curvas
+    std::vector<SceneModel> models;
+    std::vector<SceneParam> params;
+    std::vector<Light> lights;
+    std::vector<std::string> strings;  ///< Caminhos e nomes distintos
+    std::vector<uint32_t> assets;      ///< Primeiro modelo de cada geometria distinta
+
+    /// Índice de um texto em strings, acrescentando-o se ainda não existir
+    uint32_t intern(const char* text);
+
+    /**
+     * @brief Geometria identificada por um texto de strings, acrescentando-a se ainda não existir.
+     *
+     * @param key Caminho canónico do ficheiro ou descrição da figura, em strings
+     * @param model Modelo que a descreve, usado se a geometria for nova
+     *
+     * @return Índice em assets
+     */
+    uint32_t internAsset(uint32_t key, uint32_t model);
+
+    /// true se alguma transformação depende do tempo
+    bool isAnimated() const;
+
+    /**
+     * @brief Matriz de uma transformação no instante time.
+     *
+     * Translação, rotação e escala como glTranslatef, glRotatef e glScalef.
+     * A rotação temporizada dá uma volta a cada transform.time segundos e a
+     * translação temporizada percorre a curva no mesmo período; com align, o
+     * eixo X do modelo segue a tangente da curva.
+     *
+     * @param transform Transformação de um grupo desta cena
+     * @param time Tempo desde o início (s)
+     */
+    mat4 transformMatrix(const Transform& transform, float time) const;
+
+    /// Esvazia a cena (mantendo a memória dos vetores)
+    void clear();
+
+private:
+    std::unordered_map<std::string, uint32_t> stringIndex;  ///< Texto -> índice em strings
+    std::string lookup;                                     ///< Chave reutilizada por intern()
+    std::vector<uint32_t> assetIndex;                       ///< Índice em strings -> geometria, ou NO_INDEX
+};
+
+/**
+ * @brief Posição e tangente numa curva de Catmull-Rom fechada.
+ *
+ * @param points Pontos de controlo (x, y, z de cada um)
+ * @param count Número de pontos (pelo menos 4)
+ * @param t Posição global na curva: 0 no início, 1 depois de uma volta
+ * @param position Ponto da curva
+ * @param derivative Tangente (não normalizada)
+ */
+void catmullRomPoint(const float* points, uint32_t count, float t, float position[3], float derivative[3]);
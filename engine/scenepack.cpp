@@ -0,0 +1,501 @@
+#include "scenepack.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+/// Versão do formato (2: hierarquia da cena em vez de uma lista de instâncias)
+const uint32_t SCENE_PACK_VERSION = 2;
+/// Tamanho do cabeçalho
+const size_t SCENE_PACK_HEADER_SIZE = 128;
+/// Tamanho de cada entrada da tabela de malhas
+const size_t SCENE_PACK_MESH_ENTRY_SIZE = 64;
+/// Alinhamento dos blocos de dados
+const size_t SCENE_PACK_ALIGNMENT = 16;
+
+
+/// Tamanho de cada registo da cena (ver writeScene)
+const size_t SCENE_PACK_GROUP_SIZE = 28;
+const size_t SCENE_PACK_TRANSFORM_SIZE = 32;
+const size_t SCENE_PACK_MODEL_SIZE = 84;
+const size_t SCENE_PACK_PARAM_SIZE = 8;
+const size_t SCENE_PACK_LIGHT_SIZE = 32;
+
+
+// Escreve valores seguidos, sem o preenchimento das estruturas
+struct PackWriter {
+    vector<unsigned char> bytes;
+
+    void raw(const void* data, size_t size) {
+        const unsigned char* begin = (const unsigned char*)data;
+        bytes.insert(bytes.end(), begin, begin + size);
+    }
+    void u8(uint8_t value) { bytes.push_back(value); }
+    void u32(uint32_t value) { raw(&value, 4); }
+    void floats(const float* values, size_t count) { raw(values, count * sizeof(float)); }
+};
+
+// Lê valores seguidos de um bloco; uma leitura fora do bloco marca ok = false
+struct PackReader {
+    const unsigned char* data;
+    uint64_t size;
+    uint64_t position = 0;
+    bool ok = true;
+
+    PackReader(const unsigned char* data, uint64_t size) : data(data), size(size) {}
+
+    void raw(void* out, size_t count) {
+        if (!ok || count > size - position) {
+            ok = false;
+            memset(out, 0, count);
+            return;
+        }
+        memcpy(out, data + position, count);
+        position += count;
+    }
+    uint8_t u8() { uint8_t value; raw(&value, 1); return value; }
+    uint32_t u32() { uint32_t value; raw(&value, 4); return value; }
+    void floats(float* values, size_t count) { raw(values, count * sizeof(float)); }
+
+    // Número de registos seguinte, recusado se não couber no resto do bloco
+    uint32_t count(size_t recordSize) {
+        uint32_t value = u32();
+        if (ok && (uint64_t)value * recordSize > size - position) {
+            ok = false;
+        }
+        return ok ? value : 0;
+    }
+};
+
+
+static void writeScene(PackWriter& out, const Scene& scene) {
+    out.u32((uint32_t)scene.groups.size());
+    for (const SceneGroup& group : scene.groups) {
+        out.u32(group.parent);
+        out.u32(group.end);
+        out.u32(group.firstTransform);
+        out.u32(group.transformCount);
+        out.u32(group.firstModel);
+        out.u32(group.modelCount);
+        out.u32(group.instance);
+    }
+
+    out.u32((uint32_t)scene.transforms.size());
+    for (const Transform& transform : scene.transforms) {
+        out.u8((uint8_t)transform.type);
+        out.u8(transform.align ? 1 : 0);
+        out.u8(0);
+        out.u8(0);
+        out.floats(transform.xyz, 3);
+        out.floats(&transform.angle, 1);
+        out.floats(&transform.time, 1);
+        out.u32(transform.firstPoint);
+        out.u32(transform.pointCount);
+    }
+
+    out.u32((uint32_t)scene.points.size());
+    out.floats(scene.points.data(), scene.points.size());
+
+    out.u32((uint32_t)scene.models.size());
+    for (const SceneModel& model : scene.models) {
+        out.u32(model.group);
+        out.u32(model.file);
+        out.u32(model.procedural);
+        out.u32(model.firstParam);
+        out.u32(model.paramCount);
+        out.u32(model.texture);
+        out.u32(model.asset);
+        out.u32(model.hasColor ? 1 : 0);
+        out.floats(model.color.diffuse, 3);
+        out.floats(model.color.ambient, 3);
+        out.floats(model.color.specular, 3);
+        out.floats(model.color.emissive, 3);
+        out.floats(&model.color.shininess, 1);
+    }
+
+    out.u32((uint32_t)scene.params.size());
+    for (const SceneParam& param : scene.params) {
+        out.u32(param.name);
+        out.floats(&param.value, 1);
+    }
+
+    out.u32((uint32_t)scene.lights.size());
+    for (const Light& light : scene.lights) {
+        out.u8((uint8_t)light.type);
+        out.u8(0);
+        out.u8(0);
+        out.u8(0);
+        out.floats(light.position, 3);
+        out.floats(light.direction, 3);
+        out.floats(&light.cutoff, 1);
+    }
+
+    out.u32((uint32_t)scene.strings.size());
+    for (const string& text : scene.strings) {
+        out.u32((uint32_t)text.size());
+        out.raw(text.data(), text.size());
+    }
+
+    out.u32((uint32_t)scene.assets.size());
+    for (uint32_t asset : scene.assets) {
+        out.u32(asset);
+    }
+}
+
+static bool readScene(PackReader& in, Scene& scene) {
+    scene.groups.resize(in.count(SCENE_PACK_GROUP_SIZE));
+    for (SceneGroup& group : scene.groups) {
+        group.parent = in.u32();
+        group.end = in.u32();
+        group.firstTransform = in.u32();
+        group.transformCount = in.u32();
+        group.firstModel = in.u32();
+        group.modelCount = in.u32();
+        group.instance = in.u32();
+    }
+
+    scene.transforms.resize(in.count(SCENE_PACK_TRANSFORM_SIZE));
+    for (Transform& transform : scene.transforms) {
+        uint8_t type = in.u8();
+        transform.type = (TransformType)min<uint8_t>(type, (uint8_t)TransformType::TimedRotate);
+        in.ok = in.ok && type <= (uint8_t)TransformType::TimedRotate;
+        transform.align = in.u8() != 0;
+        in.u8();
+        in.u8();
+        in.floats(transform.xyz, 3);
+        in.floats(&transform.angle, 1);
+        in.floats(&transform.time, 1);
+        transform.firstPoint = in.u32();
+        transform.pointCount = in.u32();
+    }
+
+    scene.points.resize(in.count(sizeof(float)));
+    in.floats(scene.points.data(), scene.points.size());
+
+    scene.models.resize(in.count(SCENE_PACK_MODEL_SIZE));
+    for (SceneModel& model : scene.models) {
+        model.group = in.u32();
+        model.file = in.u32();
+        model.procedural = in.u32();
+        model.firstParam = in.u32();
+        model.paramCount = in.u32();
+        model.texture = in.u32();
+        model.asset = in.u32();
+        model.hasColor = in.u32() != 0;
+        in.floats(model.color.diffuse, 3);
+        in.floats(model.color.ambient, 3);
+        in.floats(model.color.specular, 3);
+        in.floats(model.color.emissive, 3);
+        in.floats(&model.color.shininess, 1);
+    }
+
+    scene.params.resize(in.count(SCENE_PACK_PARAM_SIZE));
+    for (SceneParam& param : scene.params) {
+        param.name = in.u32();
+        in.floats(&param.value, 1);
+    }
+
+    scene.lights.resize(in.count(SCENE_PACK_LIGHT_SIZE));
+    for (Light& light : scene.lights) {
+        uint8_t type = in.u8();
+        light.type = (LightType)min<uint8_t>(type, (uint8_t)LightType::Spot);
+        in.ok = in.ok && type <= (uint8_t)LightType::Spot;
+        in.u8();
+        in.u8();
+        in.u8();
+        in.floats(light.position, 3);
+        in.floats(light.direction, 3);
+        in.floats(&light.cutoff, 1);
+    }
+
+    scene.strings.resize(in.count(sizeof(uint32_t)));
+    for (string& text : scene.strings) {
+        uint32_t length = in.count(1);
+        text.assign(in.ok ? (const char*)in.data + in.position : "", length);
+        in.position += length;
+    }
+
+    scene.assets.resize(in.count(sizeof(uint32_t)));
+    for (uint32_t& asset : scene.assets) {
+        asset = in.u32();
+    }
+    return in.ok;
+}
+
+// Verifica o que o motor assume sem testar: índices dentro dos vetores, grupos
+// em pré-ordem (cada um filho do último grupo aberto) e <use> sem ciclos
+static bool validScene(const Scene& scene) {
+    size_t groupCount = scene.groups.size();
+    size_t stringCount = scene.strings.size();
+    if (groupCount == 0 || scene.groups[0].parent != NO_INDEX || scene.groups[0].end != groupCount) {
+        return false;
+    }
+
+    vector<uint32_t> open;
+    for (uint32_t g = 0; g < groupCount; g++) {
+        const SceneGroup& group = scene.groups[g];
+        while (!open.empty() && scene.groups[open.back()].end <= g) {
+            open.pop_back();
+        }
+        uint32_t parent = open.empty() ? NO_INDEX : open.back();
+        if (group.parent != parent || group.end <= g ||
+            group.end > (parent == NO_INDEX ? groupCount : scene.groups[parent].end) ||
+            (uint64_t)group.firstTransform + group.transformCount > scene.transforms.size() ||
+            (uint64_t)group.firstModel + group.modelCount > scene.models.size() ||
+            (group.instance != NO_INDEX && group.instance >= groupCount)) {
+            return false;
+        }
+        open.push_back(g);
+    }
+
+    for (const Transform& transform : scene.transforms) {
+        if (transform.type == TransformType::TimedTranslate &&
+            (transform.pointCount < 4 || transform.time <= 0 ||
+             (uint64_t)transform.firstPoint + transform.pointCount > scene.points.size() / 3)) {
+            return false;
+        }
+        if (transform.type == TransformType::TimedRotate && transform.time <= 0) {
+            return false;
+        }
+    }
+
+    auto validString = [stringCount](uint32_t index) {
+        return index == NO_INDEX || index < stringCount;
+    };
+    for (const SceneModel& model : scene.models) {
+        if (model.group >= groupCount || !validString(model.file) || !validString(model.procedural) ||
+            !validString(model.texture) || model.asset >= scene.assets.size() ||
+            (uint64_t)model.firstParam + model.paramCount > scene.params.size()) {
+            return false;
+        }
+    }
+    for (const SceneParam& param : scene.params) {
+        if (param.name >= stringCount) {
+            return false;
+        }
+    }
+    for (uint32_t asset : scene.assets) {
+        if (asset >= scene.models.size()) {
+            return false;
+        }
+    }
+
+    // Ciclos de <use>: pesquisa em profundidade a partir do <world>, em que
+    // cada protótipo é examinado uma vez, como no parser
+    enum : uint8_t { UNVISITED, VISITING, DONE };
+    vector<uint8_t> state(groupCount, UNVISITED);
+    struct Visit {
+        uint32_t prototype;
+        uint32_t next;
+    };
+    vector<Visit> stack(1, Visit{0, 0});
+    state[0] = VISITING;
+    while (!stack.empty()) {
+        Visit& visit = stack.back();
+        if (visit.next == scene.groups[visit.prototype].end) {
+            state[visit.prototype] = DONE;
+            stack.pop_back();
+            continue;
+        }
+
+        uint32_t instance = scene.groups[visit.next++].instance;
+        if (instance == NO_INDEX || state[instance] == DONE) {
+            continue;
+        }
+        if (state[instance] == VISITING) {
+            return false;
+        }
+        state[instance] = VISITING;
+        stack.push_back(Visit{instance, instance});
+    }
+    return true;
+}
+
+
+static uint64_t alignOffset(uint64_t offset) {
+    return (offset + SCENE_PACK_ALIGNMENT - 1) / SCENE_PACK_ALIGNMENT * SCENE_PACK_ALIGNMENT;
+}
+
+// Escreve zeros até à posição indicada
+static void padTo(ofstream& file, uint64_t offset) {
+    static const char zeros[SCENE_PACK_ALIGNMENT] = {};
+    uint64_t position = (uint64_t)file.tellp();
+    while (position < offset) {
+        size_t count = (size_t)min<uint64_t>(offset - position, sizeof(zeros));
+        file.write(zeros, count);
+        position += count;
+    }
+}
+
+bool writeScenePack(const string& path, const ScenePack& pack) {
+    ofstream file(path, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Erro ao abrir o ficheiro: " << path << endl;
+        return false;
+    }
+
+    PackWriter sceneData;
+    writeScene(sceneData, pack.scene);
+
+    uint32_t meshCount = (uint32_t)pack.meshes.size();
+    uint32_t assetCount = (uint32_t)pack.scene.assets.size();
+    uint64_t meshTable = SCENE_PACK_HEADER_SIZE;
+    uint64_t assetTable = meshTable + (uint64_t)meshCount * SCENE_PACK_MESH_ENTRY_SIZE;
+    uint64_t sceneOffset = assetTable + ((uint64_t)assetCount + 1) * sizeof(uint32_t);
+    uint64_t sceneSize = sceneData.bytes.size();
+
+    // Calcula a posição de cada bloco de dados
+    vector<unsigned char> entries(meshCount * SCENE_PACK_MESH_ENTRY_SIZE, 0);
+    uint64_t offset = sceneOffset + sceneSize;
+    for (uint32_t m = 0; m < meshCount; m++) {
+        const PackMesh& mesh = pack.meshes[m];
+        unsigned char* entry = entries.data() + m * SCENE_PACK_MESH_ENTRY_SIZE;
+        uint32_t nameLength = (uint32_t)mesh.name.size();
+
+        uint64_t nameOffset = offset;
+        uint64_t vertexOffset = alignOffset(nameOffset + nameLength);
+        uint64_t indexOffset = alignOffset(vertexOffset + (uint64_t)mesh.vertexCount * 3 * sizeof(float));
+        offset = indexOffset + (uint64_t)mesh.indexCount * sizeof(uint32_t);
+
+        memcpy(entry, &vertexOffset, 8);
+        memcpy(entry + 8, &indexOffset, 8);
+        memcpy(entry + 16, &mesh.vertexCount, 4);
+        memcpy(entry + 20, &mesh.indexCount, 4);
+        memcpy(entry + 24, mesh.bounds, sizeof(mesh.bounds));
+        memcpy(entry + 48, &nameOffset, 8);
+        memcpy(entry + 56, &nameLength, 4);
+    }
+
+    unsigned char header[SCENE_PACK_HEADER_SIZE] = {};
+    int32_t window[2] = {pack.windowWidth, pack.windowHeight};
+    memcpy(header, SCENE_PACK_MAGIC, 4);
+    memcpy(header + 4, &SCENE_PACK_VERSION, 4);
+    memcpy(header + 8, window, sizeof(window));
+    memcpy(header + 16, pack.camera, sizeof(pack.camera));
+    memcpy(header + 64, &meshCount, 4);
+    memcpy(header + 68, &assetCount, 4);
+    memcpy(header + 72, &meshTable, 8);
+    memcpy(header + 80, &assetTable, 8);
+    memcpy(header + 88, &sceneOffset, 8);
+    memcpy(header + 96, &sceneSize, 8);
+
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)entries.data(), entries.size());
+    file.write((const char*)pack.assetMeshes.data(), ((streamsize)assetCount + 1) * sizeof(uint32_t));
+    file.write((const char*)sceneData.bytes.data(), sceneData.bytes.size());
+
+    for (uint32_t m = 0; m < meshCount; m++) {
+        const PackMesh& mesh = pack.meshes[m];
+        const unsigned char* entry = entries.data() + m * SCENE_PACK_MESH_ENTRY_SIZE;
+        uint64_t vertexOffset, indexOffset;
+        memcpy(&vertexOffset, entry, 8);
+        memcpy(&indexOffset, entry + 8, 8);
+
+        file.write(mesh.name.data(), mesh.name.size());
+        padTo(file, vertexOffset);
+        file.write((const char*)mesh.vertices, (streamsize)mesh.vertexCount * 3 * sizeof(float));
+        padTo(file, indexOffset);
+        file.write((const char*)mesh.indices, (streamsize)mesh.indexCount * sizeof(uint32_t));
+    }
+
+    return (bool)file;
+}
+
+bool openScenePack(const string& path, ScenePack& pack) {
+    if (!pack.file.open(path)) {
+        cerr << "Erro ao abrir o pacote: " << path << endl;
+        return false;
+    }
+
+    const unsigned char* data = pack.file.data();
+    uint64_t size = pack.file.size();
+
+    uint32_t version, meshCount, assetCount;
+    uint64_t meshTable, assetTable, sceneOffset, sceneSize;
+    int32_t window[2];
+    if (size < SCENE_PACK_HEADER_SIZE || memcmp(data, SCENE_PACK_MAGIC, 4) != 0) {
+        cerr << "Pacote de cena inválido: " << path << endl;
+        pack.file.close();
+        return false;
+    }
+    memcpy(&version, data + 4, 4);
+    memcpy(window, data + 8, sizeof(window));
+    memcpy(pack.camera, data + 16, sizeof(pack.camera));
+    memcpy(&meshCount, data + 64, 4);
+    memcpy(&assetCount, data + 68, 4);
+    memcpy(&meshTable, data + 72, 8);
+    memcpy(&assetTable, data + 80, 8);
+    memcpy(&sceneOffset, data + 88, 8);
+    memcpy(&sceneSize, data + 96, 8);
+
+    if (version != SCENE_PACK_VERSION ||
+        meshTable + (uint64_t)meshCount * SCENE_PACK_MESH_ENTRY_SIZE > size ||
+        assetTable + ((uint64_t)assetCount + 1) * sizeof(uint32_t) > size ||
+        sceneOffset > size || sceneSize > size - sceneOffset) {
+        cerr << "Pacote de cena inválido: " << path << endl;
+        pack.file.close();
+        return false;
+    }
+
+    // Hierarquia da cena e intervalo de malhas de cada geometria
+    PackReader sceneData(data + sceneOffset, sceneSize);
+    pack.assetMeshes.resize((size_t)assetCount + 1);
+    memcpy(pack.assetMeshes.data(), data + assetTable, pack.assetMeshes.size() * sizeof(uint32_t));
+    bool validRanges = pack.assetMeshes.front() == 0 && pack.assetMeshes.back() == meshCount;
+    for (uint32_t a = 0; a < assetCount && validRanges; a++) {
+        validRanges = pack.assetMeshes[a] <= pack.assetMeshes[a + 1];
+    }
+    if (!readScene(sceneData, pack.scene) || !validScene(pack.scene) ||
+        pack.scene.assets.size() != assetCount || !validRanges) {
+        cerr << "Pacote de cena inválido (hierarquia): " << path << endl;
+        pack.scene.clear();
+        pack.assetMeshes.clear();
+        pack.file.close();
+        return false;
+    }
+    pack.windowWidth = window[0];
+    pack.windowHeight = window[1];
+
+    pack.meshes.resize(meshCount);
+    for (uint32_t m = 0; m < meshCount; m++) {
+        const unsigned char* entry = data + meshTable + m * SCENE_PACK_MESH_ENTRY_SIZE;
+        PackMesh& mesh = pack.meshes[m];
+        uint64_t vertexOffset, indexOffset, nameOffset;
+        uint32_t nameLength;
+        memcpy(&vertexOffset, entry, 8);
+        memcpy(&indexOffset, entry + 8, 8);
+        memcpy(&mesh.vertexCount, entry + 16, 4);
+        memcpy(&mesh.indexCount, entry + 20, 4);
+        memcpy(mesh.bounds, entry + 24, sizeof(mesh.bounds));
+        memcpy(&nameOffset, entry + 48, 8);
+        memcpy(&nameLength, entry + 56, 4);
+
+        if (vertexOffset + (uint64_t)mesh.vertexCount * 3 * sizeof(float) > size ||
+            indexOffset + (uint64_t)mesh.indexCount * sizeof(uint32_t) > size ||
+            nameOffset + nameLength > size || vertexOffset % 4 != 0 || indexOffset % 4 != 0) {
+            cerr << "Pacote de cena inválido (malha " << m << "): " << path << endl;
+            pack.meshes.clear();
+            pack.file.close();
+            return false;
+        }
+
+        mesh.name.assign((const char*)data + nameOffset, nameLength);
+        mesh.vertices = (const float*)(data + vertexOffset);
+        mesh.indices = (const uint32_t*)(data + indexOffset);
+
+        // Os índices são usados diretamente no desenho e nos lotes estáticos
+        bool validIndices = mesh.indexCount % 3 == 0;
+        for (uint32_t i = 0; i < mesh.indexCount && validIndices; i++) {
+            validIndices = mesh.indices[i] < mesh.vertexCount;
+        }
+        if (!validIndices) {
+            cerr << "Pacote de cena inválido (índices da malha " << m << "): " << path << endl;
+            pack.meshes.clear();
+            pack.file.close();
+            return false;
+        }
+    }
+    return true;
+}
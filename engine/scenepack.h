@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "modelcache.h"
+#include "scene.h"
+
+/// Identificador no início de um pacote de cena
+const char SCENE_PACK_MAGIC[4] = {'3', 'D', 'P', '1'};
+
+/**
+ * @struct PackMesh
+ * @brief Malha de um pacote de cena.
+ *
+ * Ao escrever, os ponteiros apontam para os dados do modelo carregado;
+ * ao ler, apontam para o mapeamento do pacote.
+ */
+struct PackMesh {
+    std::string name;                  ///< Ficheiro ou figura de origem
+    const float* vertices = nullptr;   ///< x, y, z de cada vértice
+    const uint32_t* indices = nullptr; ///< 3 índices por triângulo
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    float bounds[6] = {0, 0, 0, 0, 0, 0}; ///< AABB: mínimo x, y, z seguido do máximo x, y, z
+};
+
+/**
+ * @struct ScenePack
+ * @brief Cena completa: janela, câmera, hierarquia e malhas (sem repetições).
+ *
+ * As malhas de cada geometria de Scene::assets são contíguas (várias num
+ * terreno aos blocos, nenhuma se o carregamento falhou); assetMeshes dá o
+ * intervalo de cada uma, como assetSlots no motor.
+ */
+struct ScenePack {
+    MappedFile file;                   ///< Mapeamento do pacote (leitura)
+    int windowWidth = 800;
+    int windowHeight = 600;
+    float camera[12] = {0, 0, 5, 0, 0, 0, 0, 1, 0, 60, 1, 1000}; ///< Posição, lookAt, up, fov, near, far
+    Scene scene;                       ///< Grupos, transformações, modelos (com as cores) e luzes
+    std::vector<PackMesh> meshes;      ///< Malhas distintas, pela ordem de Scene::assets
+    std::vector<uint32_t> assetMeshes; ///< Primeira malha de cada geometria da cena, e o total no fim
+};
+
+/**
+ * @brief Escreve um pacote de cena.
+ *
+ * Estrutura (little-endian):
+ * - cabeçalho de 128 bytes: "3DP1", versão, janela, câmera (12 floats),
+ *   número de malhas e de geometrias, posição das tabelas e da cena
+ * - tabela de malhas: posição e contagens dos vértices e índices, AABB e nome
+ * - tabela de geometrias: primeira malha (uint32) de cada geometria e o total
+ * - a cena: cada vetor de Scene (grupos, transformações, pontos, modelos,
+ *   parâmetros, luzes, textos e geometrias), com o número de elementos
+ *   seguido de registos de tamanho fixo
+ * - os nomes e os dados das malhas, alinhados a 16 bytes
+ *
+ * @return true se o pacote foi escrito
+ */
+bool writeScenePack(const std::string& path, const ScenePack& pack);
+
+/**
+ * @brief Mapeia um pacote de cena; as malhas apontam diretamente para o mapeamento.
+ *
+ * Valida as tabelas, a hierarquia da cena (intervalos, pré-ordem e <use> sem
+ * ciclos) e todos os índices das malhas, que ficam prontos a desenhar.
+ *
+ * @return false se o ficheiro não existir ou não for um pacote válido
+ */
+bool openScenePack(const std::string& path, ScenePack& pack);
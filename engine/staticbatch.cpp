@@ -0,0 +1,136 @@
+#include "staticbatch.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <thread>
+
+using namespace std;
+
+/// Cores alternadas das faces dos modelos sem cor, como em drawModel: laranja e azul
+static const float FACE_COLORS[2][3] = {{0.8f, 0.6f, 0.2f}, {0.2f, 0.6f, 0.8f}};
+/// Vértices mínimos por thread; abaixo disto não compensa criar threads
+const size_t BATCH_VERTICES_PER_THREAD = 64 * 1024;
+
+
+/**
+ * @struct BatchPlacement
+ * @brief Lote de um modelo e posição onde começam os seus dados nesse lote.
+ */
+struct BatchPlacement {
+    uint32_t batch;
+    size_t firstVertex;
+    size_t firstIndex;
+    size_t firstTriangle;      ///< Para a alternância das cores dos lotes sem cor
+};
+
+
+static uint32_t triangleCount(const BatchSource& source) {
+    return source.indices ? source.indexCount / 3 : source.vertexCount / 3;
+}
+
+size_t batchVertexCount(const BatchSource& source) {
+    return source.color ? source.vertexCount : (size_t)triangleCount(source) * 3;
+}
+
+// Transforma e copia um modelo para a sua posição no lote
+static void fillBatch(const BatchSource& source, const BatchPlacement& placement, StaticBatch& batch) {
+    float* out = batch.vertices.data() + 3 * placement.firstVertex;
+    uint32_t triangles = triangleCount(source);
+
+    if (source.color) {
+        transformPoints(source.matrix, source.vertices, out, source.vertexCount);
+        uint32_t* indices = batch.indices.data() + placement.firstIndex;
+        uint32_t base = (uint32_t)placement.firstVertex;
+        for (uint32_t i = 0; i < triangles * 3; i++) {
+            indices[i] = base + (source.indices ? source.indices[i] : i);
+        }
+        return;
+    }
+
+    // Os vértices de cada face são copiados e depois transformados no próprio lote
+    float* colors = batch.colors.data() + 3 * placement.firstVertex;
+    float* corners = out;
+    for (uint32_t t = 0; t < triangles; t++) {
+        const float* color = FACE_COLORS[(placement.firstTriangle + t) % 2];
+        for (uint32_t corner = 0; corner < 3; corner++) {
+            uint32_t index = source.indices ? source.indices[3 * t + corner] : 3 * t + corner;
+            memcpy(corners, source.vertices + 3 * (size_t)index, 3 * sizeof(float));
+            memcpy(colors, color, 3 * sizeof(float));
+            corners += 3;
+            colors += 3;
+        }
+    }
+    transformPoints(source.matrix, out, out, (size_t)triangles * 3);
+}
+
+vector<StaticBatch> buildStaticBatches(const vector<BatchSource>& sources, unsigned int threads) {
+    vector<StaticBatch> batches;
+    vector<BatchPlacement> placements(sources.size());
+
+    // Um lote por cor difusa e um para os modelos sem cor
+    map<array<float, 3>, uint32_t> coloredBatches;
+    uint32_t uncoloredBatch = UINT32_MAX;
+    vector<size_t> vertexTotals, indexTotals, triangleTotals;
+    size_t totalVertices = 0;
+
+    for (size_t i = 0; i < sources.size(); i++) {
+        const BatchSource& source = sources[i];
+        uint32_t* found = &uncoloredBatch;
+        if (source.color) {
+            array<float, 3> key = {source.color[0], source.color[1], source.color[2]};
+            found = &coloredBatches.emplace(key, UINT32_MAX).first->second;
+        }
+        if (*found == UINT32_MAX) {
+            *found = (uint32_t)batches.size();
+            batches.emplace_back();
+            batches.back().colored = source.color != nullptr;
+            if (source.color) {
+                memcpy(batches.back().color, source.color, sizeof(batches.back().color));
+            }
+            vertexTotals.push_back(0);
+            indexTotals.push_back(0);
+            triangleTotals.push_back(0);
+        }
+
+        uint32_t b = *found;
+        placements[i] = BatchPlacement{b, vertexTotals[b], indexTotals[b], triangleTotals[b]};
+        size_t vertices = batchVertexCount(source);
+        vertexTotals[b] += vertices;
+        indexTotals[b] += source.color ? (size_t)triangleCount(source) * 3 : 0;
+        triangleTotals[b] += triangleCount(source);
+        totalVertices += vertices;
+    }
+
+    for (size_t b = 0; b < batches.size(); b++) {
+        batches[b].vertices.resize(vertexTotals[b] * 3);
+        batches[b].indices.resize(indexTotals[b]);
+        batches[b].colors.resize(batches[b].colored ? 0 : vertexTotals[b] * 3);
+    }
+
+    // Cada thread fica com modelos seguidos que somam cerca de 1/threads dos vértices
+    size_t workers = min<size_t>(max(threads, 1u), 1 + totalVertices / BATCH_VERTICES_PER_THREAD);
+    auto fillRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            fillBatch(sources[i], placements[i], batches[placements[i].batch]);
+        }
+    };
+
+    vector<thread> pool;
+    size_t begin = 0, done = 0;
+    for (size_t w = 1; w < workers; w++) {
+        size_t target = totalVertices * w / workers;
+        size_t end = begin;
+        while (end < sources.size() && done < target) {
+            done += batchVertexCount(sources[end++]);
+        }
+        pool.emplace_back(fillRange, begin, end);
+        begin = end;
+    }
+    fillRange(begin, sources.size());
+    for (thread& worker : pool) {
+        worker.join();
+    }
+
+    return batches;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "mathlib.h"
+
+/**
+ * @struct BatchSource
+ * @brief Modelo estático a juntar num lote, com a matriz com que seria desenhado.
+ *
+ * Os ponteiros apontam para os dados do modelo carregado e têm de se manter
+ * válidos durante buildStaticBatches().
+ */
+struct BatchSource {
+    const float* vertices = nullptr;   ///< x, y, z de cada vértice
+    const uint32_t* indices = nullptr; ///< 3 índices por triângulo, ou nulo (vértices 3 a 3)
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    mat4 matrix;                       ///< Transformação acumulada desde <world>
+    const float* color = nullptr;      ///< Cor difusa, ou nulo para as faces alternadas laranja/azul
+};
+
+/**
+ * @struct StaticBatch
+ * @brief Geometria já transformada de vários modelos com o mesmo material, desenhada de uma vez.
+ *
+ * Os lotes com cor são indexados (glDrawElements). Os lotes sem cor precisam
+ * de uma cor por face, pelo que os vértices não são partilhados: três por
+ * triângulo, cada um com a cor da face (glDrawArrays).
+ */
+struct StaticBatch {
+    bool colored = false;              ///< true se todos os modelos têm a cor color
+    float color[3] = {0, 0, 0};
+    std::vector<float> vertices;       ///< x, y, z de cada vértice, já transformados
+    std::vector<uint32_t> indices;     ///< Lotes com cor: 3 índices por triângulo
+    std::vector<float> colors;         ///< Lotes sem cor: r, g, b de cada vértice
+};
+
+/**
+ * @brief Junta os modelos num lote por material, transformando os vértices no CPU.
+ *
+ * As posições de cada modelo nos lotes são calculadas primeiro; depois os
+ * modelos são transformados e copiados em paralelo, cada thread com um
+ * intervalo de modelos.
+ *
+ * @param sources Modelos a juntar, pela ordem em que seriam desenhados
+ * @param threads Número máximo de threads
+ *
+ * @return Lotes, pela ordem do primeiro modelo de cada material
+ */
+std::vector<StaticBatch> buildStaticBatches(const std::vector<BatchSource>& sources, unsigned int threads);
+
+/**
+ * @brief Número de vértices que um modelo ocupa num lote.
+ */
+size_t batchVertexCount(const BatchSource& source);
@@ -32,6 +32,16 @@ distribution.
 #   include <cstdarg>
 #endif
 
+// std::from_chars (C++17): locale-free number conversion
+#if defined(__has_include)
+#   if __has_include(<charconv>) && __cplusplus >= 201703L
+#       include <charconv>
+#   endif
+#endif
+#if defined(__cpp_lib_to_chars)
+#   define TIXML_FROM_CHARS
+#endif
+
 #if defined(_MSC_VER) && (_MSC_VER >= 1400 ) && (!defined WINCE)
 	// Microsoft Visual Studio, version 2005 and higher. Not WinCE.
 	/*int _snprintf_s(
@@ -119,6 +129,15 @@ distribution.
 	#define TIXML_FTELL ftell
 #endif
 
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) ) && defined(__SSE2__)
+	// SSE2 is always there; AVX2 is detected at run time
+	#define TIXML_SIMD_X86
+	#include <immintrin.h>
+	// Aligned vector loads may read past the null, but not past its page
+	#define TIXML_NO_SANITIZE __attribute__((no_sanitize_address))
+	#define TIXML_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
 
 static const char LINE_FEED				= static_cast<char>(0x0a);			// all line endings are normalized to LF
 static const char LF = LINE_FEED;
@@ -220,17 +239,18 @@ char* StrPair::ParseText( char* p, const char* endTag, int strFlags, int* curLin
     size_t length = strlen( endTag );
 
     // Inner loop of text parsing.
-    while ( *p ) {
-        if ( *p == endChar && strncmp( p, endTag, length ) == 0 ) {
+    for( ;; ) {
+        p = const_cast<char*>( XMLUtil::FindOneOf( p, endChar, endChar, endChar, curLineNumPtr ) );
+        if ( !*p ) {
+            return 0;
+        }
+        if ( strncmp( p, endTag, length ) == 0 ) {
             Set( start, p, strFlags );
             return p + length;
-        } else if (*p == '\n') {
-            ++(*curLineNumPtr);
         }
         ++p;
         TIXMLASSERT( p );
     }
-    return 0;
 }
 
 
@@ -244,10 +264,7 @@ char* StrPair::ParseName( char* p )
     }
 
     char* const start = p;
-    ++p;
-    while ( *p && XMLUtil::IsNameChar( (unsigned char) *p ) ) {
-        ++p;
-    }
+    p = const_cast<char*>( XMLUtil::SkipNameChars( p + 1 ) );
 
     Set( start, p, 0 );
     return p;
@@ -292,8 +309,9 @@ const char* StrPair::GetStr()
         _flags ^= NEEDS_FLUSH;
 
         if ( _flags ) {
-            const char* p = _start;	// the read pointer
-            char* q = _start;	// the write pointer
+            // Everything before the first CR, LF or entity stays where it is
+            const char* p = XMLUtil::FindOneOf( _start, CR, LF, '&', 0 );	// the read pointer
+            char* q = _start + ( p - _start );	// the write pointer
 
             while( p < _end ) {
                 if ( (_flags & NEEDS_NEWLINE_NORMALIZATION) && *p == CR ) {
@@ -401,6 +419,259 @@ void XMLUtil::SetBoolSerialization(const char* writeTrue, const char* writeFalse
 }
 
 
+// Byte loops: the reference behaviour, and the fallback without SSE2.
+static const char* SkipWhiteSpaceScalar( const char* p, int* curLineNumPtr )
+{
+    while( XMLUtil::IsWhiteSpace(*p) ) {
+        if (curLineNumPtr && *p == '\n') {
+            ++(*curLineNumPtr);
+        }
+        ++p;
+    }
+    return p;
+}
+
+static const char* FindOneOfScalar( const char* p, char a, char b, char c, int* curLineNumPtr )
+{
+    while ( *p && *p != a && *p != b && *p != c ) {
+        if (curLineNumPtr && *p == '\n') {
+            ++(*curLineNumPtr);
+        }
+        ++p;
+    }
+    return p;
+}
+
+static const char* SkipNameCharsScalar( const char* p )
+{
+    while ( *p && XMLUtil::IsNameChar( (unsigned char) *p ) ) {
+        ++p;
+    }
+    return p;
+}
+
+#ifdef TIXML_SIMD_X86
+
+// Each "stop" returns a bit mask of the bytes in the block where the scan
+// must stop: bit i is byte i. The null byte always stops.
+
+static inline __m128i InRange16( __m128i v, char lo, char hi )
+{
+    // Unsigned lo <= v <= hi, as (v - lo) <= (hi - lo)
+    const __m128i limit = _mm_set1_epi8( static_cast<char>( hi - lo ) );
+    const __m128i offset = _mm_sub_epi8( v, _mm_set1_epi8( lo ) );
+    return _mm_cmpeq_epi8( _mm_max_epu8( offset, limit ), limit );
+}
+
+struct WhiteSpaceStop16 {
+    unsigned operator()( __m128i v ) const {
+        const __m128i space = _mm_or_si128( _mm_cmpeq_epi8( v, _mm_set1_epi8( ' ' ) ), InRange16( v, '\t', '\r' ) );
+        return ~static_cast<unsigned>( _mm_movemask_epi8( space ) ) & 0xFFFFu;
+    }
+};
+
+struct OneOfStop16 {
+    __m128i a, b, c;
+    OneOfStop16( char ca, char cb, char cc ) : a( _mm_set1_epi8( ca ) ), b( _mm_set1_epi8( cb ) ), c( _mm_set1_epi8( cc ) ) {}
+    unsigned operator()( __m128i v ) const {
+        const __m128i found = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( v, a ), _mm_cmpeq_epi8( v, b ) ),
+                                            _mm_or_si128( _mm_cmpeq_epi8( v, c ), _mm_cmpeq_epi8( v, _mm_setzero_si128() ) ) );
+        return static_cast<unsigned>( _mm_movemask_epi8( found ) );
+    }
+};
+
+struct NameStop16 {
+    unsigned operator()( __m128i v ) const {
+        // Letters (either case), digits and ':', '-' and '.', '_'; high bytes come from the sign bits
+        __m128i name = InRange16( _mm_or_si128( v, _mm_set1_epi8( 0x20 ) ), 'a', 'z' );
+        name = _mm_or_si128( name, InRange16( v, '0', ':' ) );
+        name = _mm_or_si128( name, InRange16( v, '-', '.' ) );
+        name = _mm_or_si128( name, _mm_cmpeq_epi8( v, _mm_set1_epi8( '_' ) ) );
+        return ~static_cast<unsigned>( _mm_movemask_epi8( name ) | _mm_movemask_epi8( v ) ) & 0xFFFFu;
+    }
+};
+
+template< class Stop >
+TIXML_NO_SANITIZE static const char* Scan16( const char* p, const Stop& stop, int* curLineNumPtr )
+{
+    const __m128i lf = _mm_set1_epi8( LF );
+    const size_t offset = reinterpret_cast<size_t>( p ) & 15;
+    const char* block = p - offset;
+    unsigned valid = ( 0xFFFFu << offset ) & 0xFFFFu;
+
+    for( ;; ) {
+        const __m128i v = _mm_load_si128( reinterpret_cast<const __m128i*>( block ) );
+        const unsigned found = stop( v ) & valid;
+        if ( curLineNumPtr ) {
+            unsigned lines = static_cast<unsigned>( _mm_movemask_epi8( _mm_cmpeq_epi8( v, lf ) ) ) & valid;
+            if ( found ) {
+                lines &= ( found & ( 0u - found ) ) - 1;	// only the bytes before the stop
+            }
+            *curLineNumPtr += __builtin_popcount( lines );
+        }
+        if ( found ) {
+            return block + __builtin_ctz( found );
+        }
+        block += 16;
+        valid = 0xFFFFu;
+    }
+}
+
+TIXML_TARGET_AVX2 static inline __m256i InRange32( __m256i v, char lo, char hi )
+{
+    const __m256i limit = _mm256_set1_epi8( static_cast<char>( hi - lo ) );
+    const __m256i offset = _mm256_sub_epi8( v, _mm256_set1_epi8( lo ) );
+    return _mm256_cmpeq_epi8( _mm256_max_epu8( offset, limit ), limit );
+}
+
+struct WhiteSpaceStop32 {
+    TIXML_TARGET_AVX2 unsigned operator()( __m256i v ) const {
+        const __m256i space = _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( ' ' ) ), InRange32( v, '\t', '\r' ) );
+        return ~static_cast<unsigned>( _mm256_movemask_epi8( space ) );
+    }
+};
+
+struct OneOfStop32 {
+    char a, b, c;
+    TIXML_TARGET_AVX2 unsigned operator()( __m256i v ) const {
+        const __m256i found = _mm256_or_si256(
+            _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( a ) ), _mm256_cmpeq_epi8( v, _mm256_set1_epi8( b ) ) ),
+            _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( c ) ), _mm256_cmpeq_epi8( v, _mm256_setzero_si256() ) ) );
+        return static_cast<unsigned>( _mm256_movemask_epi8( found ) );
+    }
+};
+
+struct NameStop32 {
+    TIXML_TARGET_AVX2 unsigned operator()( __m256i v ) const {
+        __m256i name = InRange32( _mm256_or_si256( v, _mm256_set1_epi8( 0x20 ) ), 'a', 'z' );
+        name = _mm256_or_si256( name, InRange32( v, '0', ':' ) );
+        name = _mm256_or_si256( name, InRange32( v, '-', '.' ) );
+        name = _mm256_or_si256( name, _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '_' ) ) );
+        return ~static_cast<unsigned>( _mm256_movemask_epi8( name ) | _mm256_movemask_epi8( v ) );
+    }
+};
+
+template< class Stop >
+TIXML_TARGET_AVX2 TIXML_NO_SANITIZE static const char* Scan32( const char* p, const Stop& stop, int* curLineNumPtr )
+{
+    const __m256i lf = _mm256_set1_epi8( LF );
+    const size_t offset = reinterpret_cast<size_t>( p ) & 31;
+    const char* block = p - offset;
+    unsigned valid = 0xFFFFFFFFu << offset;
+
+    for( ;; ) {
+        const __m256i v = _mm256_load_si256( reinterpret_cast<const __m256i*>( block ) );
+        const unsigned found = stop( v ) & valid;
+        if ( curLineNumPtr ) {
+            unsigned lines = static_cast<unsigned>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( v, lf ) ) ) & valid;
+            if ( found ) {
+                lines &= ( found & ( 0u - found ) ) - 1;
+            }
+            *curLineNumPtr += __builtin_popcount( lines );
+        }
+        if ( found ) {
+            return block + __builtin_ctz( found );
+        }
+        block += 32;
+        valid = 0xFFFFFFFFu;
+    }
+}
+
+static const char* SkipWhiteSpaceSSE2( const char* p, int* curLineNumPtr )
+{
+    return Scan16( p, WhiteSpaceStop16(), curLineNumPtr );
+}
+
+static const char* FindOneOfSSE2( const char* p, char a, char b, char c, int* curLineNumPtr )
+{
+    return Scan16( p, OneOfStop16( a, b, c ), curLineNumPtr );
+}
+
+static const char* SkipNameCharsSSE2( const char* p )
+{
+    return Scan16( p, NameStop16(), 0 );
+}
+
+TIXML_TARGET_AVX2 static const char* SkipWhiteSpaceAVX2( const char* p, int* curLineNumPtr )
+{
+    return Scan32( p, WhiteSpaceStop32(), curLineNumPtr );
+}
+
+TIXML_TARGET_AVX2 static const char* FindOneOfAVX2( const char* p, char a, char b, char c, int* curLineNumPtr )
+{
+    const OneOfStop32 stop = { a, b, c };
+    return Scan32( p, stop, curLineNumPtr );
+}
+
+TIXML_TARGET_AVX2 static const char* SkipNameCharsAVX2( const char* p )
+{
+    return Scan32( p, NameStop32(), 0 );
+}
+
+#endif	// TIXML_SIMD_X86
+
+struct ScanKernels {
+    const char* (*skipWhiteSpace)( const char* p, int* curLineNumPtr );
+    const char* (*findOneOf)( const char* p, char a, char b, char c, int* curLineNumPtr );
+    const char* (*skipNameChars)( const char* p );
+    const char* level;
+};
+
+static ScanKernels SelectScanKernels( bool simd )
+{
+#ifdef TIXML_SIMD_X86
+    if ( simd ) {
+        __builtin_cpu_init();
+        if ( __builtin_cpu_supports( "avx2" ) ) {
+            const ScanKernels avx2 = { SkipWhiteSpaceAVX2, FindOneOfAVX2, SkipNameCharsAVX2, "avx2" };
+            return avx2;
+        }
+        const ScanKernels sse2 = { SkipWhiteSpaceSSE2, FindOneOfSSE2, SkipNameCharsSSE2, "sse2" };
+        return sse2;
+    }
+#else
+    (void)simd;
+#endif
+    const ScanKernels scalar = { SkipWhiteSpaceScalar, FindOneOfScalar, SkipNameCharsScalar, "scalar" };
+    return scalar;
+}
+
+// Chosen on first use, so parsing during static initialization is fine
+static ScanKernels& CurrentScanKernels()
+{
+    static ScanKernels kernels = SelectScanKernels( true );
+    return kernels;
+}
+
+const char* XMLUtil::SkipWhiteSpaceRun( const char* p, int* curLineNumPtr )
+{
+    TIXMLASSERT( p );
+    return CurrentScanKernels().skipWhiteSpace( p, curLineNumPtr );
+}
+
+const char* XMLUtil::FindOneOf( const char* p, char a, char b, char c, int* curLineNumPtr )
+{
+    TIXMLASSERT( p );
+    return CurrentScanKernels().findOneOf( p, a, b, c, curLineNumPtr );
+}
+
+const char* XMLUtil::SkipNameChars( const char* p )
+{
+    TIXMLASSERT( p );
+    return CurrentScanKernels().skipNameChars( p );
+}
+
+void XMLUtil::SetSIMDEnabled( bool enabled )
+{
+    CurrentScanKernels() = SelectScanKernels( enabled );
+}
+
+const char* XMLUtil::SIMDLevel()
+{
+    return CurrentScanKernels().level;
+}
+
+
 const char* XMLUtil::ReadBOM( const char* p, bool* bom )
 {
     TIXMLASSERT( p );
@@ -613,6 +884,34 @@ void XMLUtil::ToStr( uint64_t v, char* buffer, int bufferSize )
     TIXML_SNPRINTF(buffer, bufferSize, "%llu", (long long)v);
 }
 
+#ifdef TIXML_FROM_CHARS
+// Fast path for the plain forms: a digit or '.' first, optionally after '-'.
+// from_chars rounds exactly like the C library (to nearest), so the value is
+// bit for bit what sscanf gives. Anything else (white space, '+', inf, nan,
+// hex, out of range) is left to sscanf.
+template< class T >
+static bool FromChars( const char* str, T* value )
+{
+    const char first = ( *str == '-' ) ? *(str+1) : *str;
+    if ( !( ( first >= '0' && first <= '9' ) || first == '.' ) ) {
+        return false;
+    }
+    T v;
+    const std::from_chars_result result = std::from_chars( str, str + strlen( str ), v );
+    if ( result.ec != std::errc() || *result.ptr == 'x' || *result.ptr == 'X' ) {
+        return false;
+    }
+    *value = v;
+    return true;
+}
+#else
+template< class T >
+static bool FromChars( const char*, T* )
+{
+    return false;
+}
+#endif
+
 bool XMLUtil::ToInt(const char* str, int* value)
 {
     if (IsPrefixHex(str)) {
@@ -623,7 +922,7 @@ bool XMLUtil::ToInt(const char* str, int* value)
         }
     }
     else {
-        if (TIXML_SSCANF(str, "%d", value) == 1) {
+        if (FromChars(str, value) || TIXML_SSCANF(str, "%d", value) == 1) {
             return true;
         }
     }
@@ -632,7 +931,7 @@ bool XMLUtil::ToInt(const char* str, int* value)
 
 bool XMLUtil::ToUnsigned(const char* str, unsigned* value)
 {
-    if (TIXML_SSCANF(str, IsPrefixHex(str) ? "%x" : "%u", value) == 1) {
+    if (FromChars(str, value) || TIXML_SSCANF(str, IsPrefixHex(str) ? "%x" : "%u", value) == 1) {
         return true;
     }
     return false;
@@ -666,7 +965,7 @@ bool XMLUtil::ToBool( const char* str, bool* value )
 
 bool XMLUtil::ToFloat( const char* str, float* value )
 {
-    if ( TIXML_SSCANF( str, "%f", value ) == 1 ) {
+    if ( FromChars( str, value ) || TIXML_SSCANF( str, "%f", value ) == 1 ) {
         return true;
     }
     return false;
@@ -675,7 +974,7 @@ bool XMLUtil::ToFloat( const char* str, float* value )
 
 bool XMLUtil::ToDouble( const char* str, double* value )
 {
-    if ( TIXML_SSCANF( str, "%lf", value ) == 1 ) {
+    if ( FromChars( str, value ) || TIXML_SSCANF( str, "%lf", value ) == 1 ) {
         return true;
     }
     return false;
@@ -693,7 +992,7 @@ bool XMLUtil::ToInt64(const char* str, int64_t* value)
     }
     else {
         long long v = 0;	// horrible syntax trick to make the compiler happy about %lld
-        if (TIXML_SSCANF(str, "%lld", &v) == 1) {
+        if (FromChars(str, &v) || TIXML_SSCANF(str, "%lld", &v) == 1) {
             *value = static_cast<int64_t>(v);
             return true;
         }
@@ -704,7 +1003,7 @@ bool XMLUtil::ToInt64(const char* str, int64_t* value)
 
 bool XMLUtil::ToUnsigned64(const char* str, uint64_t* value) {
     unsigned long long v = 0;	// horrible syntax trick to make the compiler happy about %llu
-    if(TIXML_SSCANF(str, IsPrefixHex(str) ? "%llx" : "%llu", &v) == 1) {
+    if(FromChars(str, &v) || TIXML_SSCANF(str, IsPrefixHex(str) ? "%llx" : "%llu", &v) == 1) {
         *value = (uint64_t)v;
         return true;
     }
@@ -1698,6 +1997,28 @@ float XMLElement::FloatAttribute(const char* name, float defaultValue) const
 	return f;
 }
 
+XMLError XMLElement::QueryFloatAttributes( const char* const* names, int count, float* values ) const
+{
+    TIXMLASSERT( names || count == 0 );
+    XMLError result = XML_SUCCESS;
+    int found = 0;
+    for( const XMLAttribute* a = _rootAttribute; a && found < count; a = a->_next ) {
+        for( int i = 0; i < count; ++i ) {
+            if ( XMLUtil::StringEqual( a->Name(), names[i] ) ) {
+                ++found;
+                if ( a->QueryFloatValue( &values[i] ) != XML_SUCCESS ) {
+                    result = XML_WRONG_ATTRIBUTE_TYPE;
+                }
+                break;
+            }
+        }
+    }
+    if ( found < count && result == XML_SUCCESS ) {
+        result = XML_NO_ATTRIBUTE;
+    }
+    return result;
+}
+
 const char* XMLElement::GetText() const
 {
     /* skip comment node */
@@ -2202,6 +2523,9 @@ XMLDocument::XMLDocument( bool processEntities, Whitespace whitespaceMode ) :
     _errorStr(),
     _errorLineNum( 0 ),
     _charBuffer( 0 ),
+    _charBufferCapacity( 0 ),
+    _parseBuffer( 0 ),
+    _reuseBuffers( false ),
     _parseCurLineNum( 0 ),
 	_parsingDepth(0),
     _unlinked(),
@@ -2217,6 +2541,7 @@ XMLDocument::XMLDocument( bool processEntities, Whitespace whitespaceMode ) :
 
 XMLDocument::~XMLDocument()
 {
+    _reuseBuffers = false;
     Clear();
 }
 
@@ -2246,8 +2571,12 @@ void XMLDocument::Clear()
 #endif
     ClearError();
 
-    delete [] _charBuffer;
-    _charBuffer = 0;
+    if ( !_reuseBuffers ) {
+        delete [] _charBuffer;
+        _charBuffer = 0;
+        _charBufferCapacity = 0;
+    }
+    _parseBuffer = 0;
 	_parsingDepth = 0;
 
 #if 0
@@ -2268,6 +2597,48 @@ void XMLDocument::Clear()
 }
 
 
+void XMLDocument::SetPoolBlockSize( int elementBytes, int attributeBytes )
+{
+    _elementPool.SetBlockSize( elementBytes );
+    _attributePool.SetBlockSize( attributeBytes );
+}
+
+
+void XMLDocument::SetBlockAllocator( XMLBlockAllocator* allocator )
+{
+    _elementPool.SetAllocator( allocator );
+    _attributePool.SetAllocator( allocator );
+    _textPool.SetAllocator( allocator );
+    _commentPool.SetAllocator( allocator );
+}
+
+
+void XMLDocument::ReleaseMemory()
+{
+    const bool reuse = _reuseBuffers;
+    _reuseBuffers = false;
+    Clear();
+    _reuseBuffers = reuse;
+
+    _elementPool.Clear();
+    _attributePool.Clear();
+    _textPool.Clear();
+    _commentPool.Clear();
+}
+
+
+// Makes _charBuffer hold at least 'size' bytes, reusing it when allowed.
+void XMLDocument::ReserveCharBuffer( size_t size )
+{
+    if ( _charBuffer && _reuseBuffers && _charBufferCapacity >= size ) {
+        return;
+    }
+    delete [] _charBuffer;
+    _charBuffer = new char[size];
+    _charBufferCapacity = size;
+}
+
+
 void XMLDocument::DeepCopy(XMLDocument* target) const
 {
 	TIXMLASSERT(target);
@@ -2412,8 +2783,7 @@ XMLError XMLDocument::LoadFile( FILE* fp )
     }
 
     const size_t size = static_cast<size_t>(filelength);
-    TIXMLASSERT( _charBuffer == 0 );
-    _charBuffer = new char[size+1];
+    ReserveCharBuffer( size+1 );
     const size_t read = fread( _charBuffer, 1, size, fp );
     if ( read != size ) {
         SetError( XML_ERROR_FILE_READ_ERROR, 0, 0 );
@@ -2421,6 +2791,7 @@ XMLError XMLDocument::LoadFile( FILE* fp )
     }
 
     _charBuffer[size] = 0;
+    _parseBuffer = _charBuffer;
 
     Parse();
     return _errorID;
@@ -2468,10 +2839,10 @@ XMLError XMLDocument::Parse( const char* xml, size_t nBytes )
     if ( nBytes == static_cast<size_t>(-1) ) {
         nBytes = strlen( xml );
     }
-    TIXMLASSERT( _charBuffer == 0 );
-    _charBuffer = new char[ nBytes+1 ];
+    ReserveCharBuffer( nBytes+1 );
     memcpy( _charBuffer, xml, nBytes );
     _charBuffer[nBytes] = 0;
+    _parseBuffer = _charBuffer;
 
     Parse();
     if ( Error() ) {
@@ -2488,6 +2859,30 @@ XMLError XMLDocument::Parse( const char* xml, size_t nBytes )
 }
 
 
+XMLError XMLDocument::ParseInPlace( char* xml, size_t nBytes )
+{
+    Clear();
+
+    if ( nBytes == 0 || !xml || !*xml ) {
+        SetError( XML_ERROR_EMPTY_DOCUMENT, 0, 0 );
+        return _errorID;
+    }
+    xml[nBytes] = 0;
+    _parseBuffer = xml;
+
+    Parse();
+    if ( Error() ) {
+        // same clean up as Parse()
+        DeleteChildren();
+        _elementPool.Clear();
+        _attributePool.Clear();
+        _textPool.Clear();
+        _commentPool.Clear();
+    }
+    return _errorID;
+}
+
+
 void XMLDocument::Print( XMLPrinter* streamer ) const
 {
     if ( streamer ) {
@@ -2562,10 +2957,10 @@ const char* XMLDocument::ErrorName() const
 void XMLDocument::Parse()
 {
     TIXMLASSERT( NoChildren() ); // Clear() must have been called previously
-    TIXMLASSERT( _charBuffer );
+    TIXMLASSERT( _parseBuffer );
     _parseCurLineNum = 1;
     _parseLineNum = 1;
-    char* p = _charBuffer;
+    char* p = _parseBuffer;
     p = XMLUtil::SkipWhiteSpace( p, &_parseCurLineNum );
     p = const_cast<char*>( XMLUtil::ReadBOM( p, &_writeBOM ) );
     if ( !*p ) {
@@ -3028,4 +3423,453 @@ bool XMLPrinter::Visit( const XMLUnknown& unknown )
     return true;
 }
 
+
+// --------- XMLPullParser ----------- //
+
+XMLPullParser::XMLPullParser( size_t bufferSize, bool processEntities ) :
+    _fp( 0 ),
+    _ownsFile( false ),
+    _eof( true ),
+    _buffer( 0 ),
+    _capacity( bufferSize < 64 ? 64 : bufferSize ),
+    _pos( 0 ),
+    _end( 0 ),
+    _processEntities( processEntities ),
+    _pendingEnd( false ),
+    _popPending( false ),
+    _tagAtPos( false ),
+    _errorID( XML_SUCCESS ),
+    _errorLineNum( 0 ),
+    _lineNum( 1 ),
+    _eventLineNum( 0 ),
+    _name( 0 ),
+    _text( 0 )
+{
+}
+
+
+XMLPullParser::~XMLPullParser()
+{
+    Close();
+    delete [] _buffer;
+}
+
+
+XMLError XMLPullParser::Open( const char* filename )
+{
+    Close();
+    FILE* fp = filename ? callfopen( filename, "rb" ) : 0;
+    if ( !fp ) {
+        _errorID = XML_ERROR_FILE_NOT_FOUND;
+        return _errorID;
+    }
+    Open( fp );
+    _ownsFile = true;
+    return _errorID;
+}
+
+
+XMLError XMLPullParser::Open( FILE* fp )
+{
+    Close();
+    TIXMLASSERT( fp );
+    if ( !_buffer ) {
+        _buffer = new char[_capacity];
+        _buffer[0] = 0;
+    }
+    _fp = fp;
+    _eof = false;
+
+    Ensure( 3 );
+    bool bom = false;
+    _pos = XMLUtil::ReadBOM( _buffer + _pos, &bom ) - _buffer;
+    return _errorID;
+}
+
+
+void XMLPullParser::Close()
+{
+    if ( _fp && _ownsFile ) {
+        fclose( _fp );
+    }
+    _fp = 0;
+    _ownsFile = false;
+    _eof = true;
+    _pos = 0;
+    _end = 0;
+    if ( _buffer ) {
+        _buffer[0] = 0;
+    }
+    _pendingEnd = false;
+    _popPending = false;
+    _tagAtPos = false;
+    _errorID = XML_SUCCESS;
+    _errorLineNum = 0;
+    _lineNum = 1;
+    _eventLineNum = 0;
+    _name = 0;
+    _text = 0;
+    _attributes.Clear();
+    _openNames.Clear();
+    _openOffsets.Clear();
+}
+
+
+// Reads more input, keeping the bytes from _pos on: they move to the start of
+// the buffer, which only grows when they fill it. Returns false at the end.
+bool XMLPullParser::Fill()
+{
+    if ( _eof ) {
+        return false;
+    }
+    if ( _pos > 0 ) {
+        memmove( _buffer, _buffer + _pos, _end - _pos );
+        _end -= _pos;
+        _pos = 0;
+    }
+    if ( _end + 1 >= _capacity ) {
+        char* buffer = new char[_capacity * 2];
+        memcpy( buffer, _buffer, _end );
+        delete [] _buffer;
+        _buffer = buffer;
+        _capacity *= 2;
+    }
+    const size_t read = fread( _buffer + _end, 1, _capacity - 1 - _end, _fp );
+    _end += read;
+    _buffer[_end] = 0;
+    if ( read == 0 ) {
+        _eof = true;
+        if ( ferror( _fp ) ) {
+            SetError( XML_ERROR_FILE_READ_ERROR );
+        }
+    }
+    return read > 0;
+}
+
+
+// Makes at least 'count' bytes available from _pos, unless the input ends first.
+void XMLPullParser::Ensure( size_t count )
+{
+    while ( _end - _pos < count && Fill() ) {
+    }
+}
+
+
+// Finds the end of the token at _pos + offset, reading more input as needed:
+// 'endTag', or the '>' of a tag (outside quoted values) if it is null.
+// Returns where the search stopped: on a null, if the input ended first
+// (at _buffer + _end) or holds a null byte.
+char* XMLPullParser::Scan( size_t offset, const char* endTag )
+{
+    for( ;; ) {
+        char* p = _buffer + _pos + offset;
+        if ( endTag ) {
+            const size_t length = strlen( endTag );
+            for( ;; ) {
+                p = const_cast<char*>( XMLUtil::FindOneOf( p, *endTag, *endTag, *endTag, 0 ) );
+                if ( !*p || strncmp( p, endTag, length ) == 0 ) {
+                    break;
+                }
+                ++p;
+            }
+        }
+        else {
+            for( ;; ) {
+                p = const_cast<char*>( XMLUtil::FindOneOf( p, '>', SINGLE_QUOTE, DOUBLE_QUOTE, 0 ) );
+                if ( *p == '>' || !*p ) {
+                    break;
+                }
+                p = const_cast<char*>( XMLUtil::FindOneOf( p + 1, *p, *p, *p, 0 ) );
+                if ( !*p ) {
+                    break;
+                }
+                ++p;
+            }
+        }
+        if ( *p || p < _buffer + _end || !Fill() ) {
+            return p;
+        }
+    }
+}
+
+
+// Moves _pos to 'end', counting the lines of the consumed bytes.
+void XMLPullParser::Consume( char* end )
+{
+    const char* p = _buffer + _pos;
+    while ( ( p = static_cast<const char*>( memchr( p, LF, end - p ) ) ) != 0 ) {
+        ++_lineNum;
+        ++p;
+    }
+    _pos = end - _buffer;
+}
+
+
+XMLPullParser::Event XMLPullParser::Next()
+{
+    if ( _errorID != XML_SUCCESS ) {
+        return PARSE_ERROR;
+    }
+    _name = 0;
+    _text = 0;
+    _attributes.Clear();
+
+    if ( _popPending ) {
+        _openNames.PopArr( _openNames.Size() - _openOffsets.Pop() );
+        _popPending = false;
+    }
+    if ( _pendingEnd ) {
+        _pendingEnd = false;
+        return CloseElement();
+    }
+    if ( _tagAtPos ) {
+        _buffer[_pos] = '<';
+        _tagAtPos = false;
+    }
+    if ( !_buffer ) {
+        return END_DOCUMENT;
+    }
+
+    for( ;; ) {
+        // White space is kept (it is part of the text that may follow it)
+        size_t space = 0;
+        for( ;; ) {
+            space = XMLUtil::SkipWhiteSpace( _buffer + _pos + space, 0 ) - ( _buffer + _pos );
+            if ( _pos + space < _end || !Fill() ) {
+                break;
+            }
+        }
+        if ( _errorID != XML_SUCCESS ) {
+            return PARSE_ERROR;
+        }
+        char* p = _buffer + _pos + space;
+        if ( *p != '<' && p < _buffer + _end ) {
+            // Text, up to the next tag; its line is
+            // the one of the first character that is not white space
+            _eventLineNum = _lineNum;
+            for( const char* q = _buffer + _pos; ( q = static_cast<const char*>( memchr( q, LF, p - q ) ) ) != 0; ++q ) {
+                ++_eventLineNum;
+            }
+            char* end = Scan( space, "<" );
+            if ( !*end ) {
+                return SetError( XML_ERROR_PARSING_TEXT );
+            }
+            char* start = _buffer + _pos;
+            Consume( end );
+            _tagAtPos = true;
+            StrPair text;
+            text.Set( start, end, _processEntities ? StrPair::TEXT_ELEMENT : StrPair::TEXT_ELEMENT_LEAVE_ENTITIES );
+            _text = text.GetStr();
+            return TEXT;
+        }
+
+        Consume( p );
+        _eventLineNum = _lineNum;
+        if ( _pos == _end ) {
+            if ( Depth() > 0 ) {
+                return SetError( XML_ERROR_PARSING );	// unclosed element
+            }
+            return END_DOCUMENT;
+        }
+        if ( *p == 0 ) {
+            return SetError( XML_ERROR_PARSING );
+        }
+        Ensure( 9 );	// the longest prefix, "<![CDATA["
+        p = _buffer + _pos;
+
+        const char* endTag = 0;
+        size_t prefix = 1;
+        if ( XMLUtil::StringEqual( p, "<?", 2 ) ) {
+            endTag = "?>";
+            prefix = 2;
+        }
+        else if ( XMLUtil::StringEqual( p, "<!--", 4 ) ) {
+            endTag = "-->";
+            prefix = 4;
+        }
+        else if ( XMLUtil::StringEqual( p, "<![CDATA[", 9 ) ) {
+            endTag = "]]>";
+            prefix = 9;
+        }
+        else if ( XMLUtil::StringEqual( p, "<!", 2 ) ) {
+            endTag = ">";
+            prefix = 2;
+        }
+        else if ( p[1] != '/' && !XMLUtil::IsNameStartChar( (unsigned char) p[1] ) ) {
+            return SetError( XML_ERROR_PARSING_ELEMENT );
+        }
+
+        char* end = Scan( prefix, endTag );
+        if ( !*end ) {
+            return SetError( endTag ? XML_ERROR_PARSING : XML_ERROR_PARSING_ELEMENT );
+        }
+        p = _buffer + _pos;
+
+        if ( !endTag ) {
+            return ( p[1] == '/' ) ? EndElement( p, end ) : StartElement( p, end );
+        }
+        Consume( end + strlen( endTag ) );
+        if ( prefix == 9 ) {
+            StrPair text;
+            text.Set( p + prefix, end, StrPair::NEEDS_NEWLINE_NORMALIZATION );
+            _text = text.GetStr();
+            return TEXT;
+        }
+        // Comment, declaration or DOCTYPE: skipped
+    }
+}
+
+
+XMLPullParser::Event XMLPullParser::StartElement( char* p, char* tagEnd )
+{
+    Consume( tagEnd + 1 );
+
+    char* const name = p + 1;
+    char* const nameEnd = const_cast<char*>( XMLUtil::SkipNameChars( name + 1 ) );
+    const int flags = _processEntities ? StrPair::ATTRIBUTE_VALUE : StrPair::ATTRIBUTE_VALUE_LEAVE_ENTITIES;
+    bool empty = false;
+
+    p = nameEnd;
+    for( ;; ) {
+        p = XMLUtil::SkipWhiteSpace( p, 0 );
+        if ( p == tagEnd ) {
+            break;
+        }
+        if ( *p == '/' && p + 1 == tagEnd ) {
+            empty = true;
+            break;
+        }
+        if ( !XMLUtil::IsNameStartChar( (unsigned char) *p ) ) {
+            return SetError( XML_ERROR_PARSING_ELEMENT );
+        }
+
+        // name = "value": Scan() has already matched the quotes
+        char* const attributeName = p;
+        char* const attributeNameEnd = const_cast<char*>( XMLUtil::SkipNameChars( p + 1 ) );
+        p = XMLUtil::SkipWhiteSpace( attributeNameEnd, 0 );
+        if ( *p != '=' ) {
+            return SetError( XML_ERROR_PARSING_ATTRIBUTE );
+        }
+        p = XMLUtil::SkipWhiteSpace( p + 1, 0 );
+        if ( *p != SINGLE_QUOTE && *p != DOUBLE_QUOTE ) {
+            return SetError( XML_ERROR_PARSING_ATTRIBUTE );
+        }
+        char* const value = p + 1;
+        char* const valueEnd = const_cast<char*>( XMLUtil::FindOneOf( value, *p, *p, *p, 0 ) );
+        p = valueEnd + 1;
+
+        *attributeNameEnd = 0;
+        if ( Attribute( attributeName ) ) {
+            return SetError( XML_ERROR_PARSING_ATTRIBUTE );	// repeated, as in XMLElement
+        }
+        StrPair decoded;
+        decoded.Set( value, valueEnd, flags );
+        _attributes.Push( attributeName );
+        _attributes.Push( decoded.GetStr() );
+    }
+
+    *nameEnd = 0;
+    const int length = static_cast<int>( nameEnd - name ) + 1;
+    _openOffsets.Push( _openNames.Size() );
+    memcpy( _openNames.PushArr( length ), name, length );
+    _name = name;
+    _pendingEnd = empty;
+    return START_ELEMENT;
+}
+
+
+XMLPullParser::Event XMLPullParser::EndElement( char* p, char* tagEnd )
+{
+    Consume( tagEnd + 1 );
+
+    char* const name = p + 2;
+    if ( !XMLUtil::IsNameStartChar( (unsigned char) *name ) ) {
+        return SetError( XML_ERROR_PARSING_ELEMENT );
+    }
+    char* const nameEnd = const_cast<char*>( XMLUtil::SkipNameChars( name + 1 ) );
+    if ( XMLUtil::SkipWhiteSpace( nameEnd, 0 ) != tagEnd ) {
+        return SetError( XML_ERROR_PARSING_ELEMENT );
+    }
+    *nameEnd = 0;
+    if ( Depth() == 0 || !XMLUtil::StringEqual( name, _openNames.Mem() + _openOffsets[Depth() - 1] ) ) {
+        return SetError( XML_ERROR_MISMATCHED_ELEMENT );
+    }
+    return CloseElement();
+}
+
+
+// END_ELEMENT for the innermost open element; it leaves the stack on the next call.
+XMLPullParser::Event XMLPullParser::CloseElement()
+{
+    TIXMLASSERT( Depth() > 0 );
+    _name = _openNames.Mem() + _openOffsets[Depth() - 1];
+    _popPending = true;
+    return END_ELEMENT;
+}
+
+
+XMLPullParser::Event XMLPullParser::SetError( XMLError error )
+{
+    _errorID = error;
+    _errorLineNum = _lineNum;
+    _name = 0;
+    _text = 0;
+    _attributes.Clear();
+    return PARSE_ERROR;
+}
+
+
+const char* XMLPullParser::Attribute( const char* name ) const
+{
+    for( int i = 0; i < _attributes.Size(); i += 2 ) {
+        if ( XMLUtil::StringEqual( _attributes[i], name ) ) {
+            return _attributes[i + 1];
+        }
+    }
+    return 0;
+}
+
+
+XMLError XMLPullParser::QueryIntAttribute( const char* name, int* value ) const
+{
+    const char* v = Attribute( name );
+    if ( !v ) {
+        return XML_NO_ATTRIBUTE;
+    }
+    return XMLUtil::ToInt( v, value ) ? XML_SUCCESS : XML_WRONG_ATTRIBUTE_TYPE;
+}
+
+
+XMLError XMLPullParser::QueryFloatAttribute( const char* name, float* value ) const
+{
+    const char* v = Attribute( name );
+    if ( !v ) {
+        return XML_NO_ATTRIBUTE;
+    }
+    return XMLUtil::ToFloat( v, value ) ? XML_SUCCESS : XML_WRONG_ATTRIBUTE_TYPE;
+}
+
+
+XMLError XMLPullParser::QueryFloatAttributes( const char* const* names, int count, float* values ) const
+{
+    TIXMLASSERT( names || count == 0 );
+    XMLError result = XML_SUCCESS;
+    int found = 0;
+    for( int a = 0; a < _attributes.Size() && found < count; a += 2 ) {
+        for( int i = 0; i < count; ++i ) {
+            if ( XMLUtil::StringEqual( _attributes[a], names[i] ) ) {
+                ++found;
+                if ( !XMLUtil::ToFloat( _attributes[a + 1], &values[i] ) ) {
+                    result = XML_WRONG_ATTRIBUTE_TYPE;
+                }
+                break;
+            }
+        }
+    }
+    if ( found < count && result == XML_SUCCESS ) {
+        result = XML_NO_ATTRIBUTE;
+    }
+    return result;
+}
+
 }   // namespace tinyxml2
@@ -320,6 +320,24 @@ private:
 };
 
 
+/**
+	Source of the memory blocks used by the node pools of an XMLDocument.
+	By default blocks come from new[]; an XMLBlockAllocator lets the
+	application supply them from its own arena instead.
+
+	Blocks must be aligned for any node type (pointers and doubles).
+	Deallocate() is called for every block when the pools are released,
+	with the same size that was requested.
+*/
+class TINYXML2_LIB XMLBlockAllocator
+{
+public:
+    virtual ~XMLBlockAllocator() {}
+    virtual void* Allocate( size_t size ) = 0;
+    virtual void Deallocate( void* mem, size_t size ) = 0;
+};
+
+
 /*
 	Parent virtual class of a pool for fast allocation
 	and deallocation of objects.
@@ -344,7 +362,8 @@ template< int ITEM_SIZE >
 class MemPoolT : public MemPool
 {
 public:
-    MemPoolT() : _blockPtrs(), _root(0), _currentAllocs(0), _nAllocs(0), _maxAllocs(0), _nUntracked(0)	{}
+    MemPoolT() : _blockPtrs(), _root(0), _currentAllocs(0), _nAllocs(0), _maxAllocs(0), _nUntracked(0),
+        _itemsPerBlock(ITEMS_PER_BLOCK), _allocator(0)	{}
     ~MemPoolT() {
         MemPoolT< ITEM_SIZE >::Clear();
     }
@@ -352,8 +371,13 @@ public:
     void Clear() {
         // Delete the blocks.
         while( !_blockPtrs.Empty()) {
-            Block* lastBlock = _blockPtrs.Pop();
-            delete lastBlock;
+            Block lastBlock = _blockPtrs.Pop();
+            if ( _allocator ) {
+                _allocator->Deallocate( lastBlock.items, sizeof( Item ) * static_cast<size_t>(lastBlock.count) );
+            }
+            else {
+                delete [] lastBlock.items;
+            }
         }
         _root = 0;
         _currentAllocs = 0;
@@ -372,14 +396,21 @@ public:
     virtual void* Alloc() override{
         if ( !_root ) {
             // Need a new block.
-            Block* block = new Block;
+            Block block;
+            block.count = _itemsPerBlock;
+            if ( _allocator ) {
+                block.items = static_cast<Item*>( _allocator->Allocate( sizeof( Item ) * static_cast<size_t>(block.count) ) );
+            }
+            else {
+                block.items = new Item[static_cast<size_t>(block.count)];
+            }
             _blockPtrs.Push( block );
 
-            Item* blockItems = block->items;
-            for( int i = 0; i < ITEMS_PER_BLOCK - 1; ++i ) {
+            Item* blockItems = block.items;
+            for( int i = 0; i < block.count - 1; ++i ) {
                 blockItems[i].next = &(blockItems[i + 1]);
             }
-            blockItems[ITEMS_PER_BLOCK - 1].next = 0;
+            blockItems[block.count - 1].next = 0;
             _root = blockItems;
         }
         Item* const result = _root;
@@ -421,6 +452,17 @@ public:
         return _nUntracked;
     }
 
+    // Size in bytes of the blocks allocated from now on (at least one item).
+    void SetBlockSize( int bytes ) {
+        _itemsPerBlock = bytes / ITEM_SIZE > 0 ? bytes / ITEM_SIZE : 1;
+    }
+
+    // Source of the blocks. Only valid while the pool has no blocks.
+    void SetAllocator( XMLBlockAllocator* allocator ) {
+        TIXMLASSERT( _blockPtrs.Empty() );
+        _allocator = allocator;
+    }
+
 	// This number is perf sensitive. 4k seems like a good tradeoff on my machine.
 	// The test file is large, 170k.
 	// Release:		VS2010 gcc(no opt)
@@ -443,15 +485,18 @@ private:
         char    itemData[static_cast<size_t>(ITEM_SIZE)];
     };
     struct Block {
-        Item items[ITEMS_PER_BLOCK];
+        Item*   items;
+        int     count;
     };
-    DynArray< Block*, 10 > _blockPtrs;
+    DynArray< Block, 10 > _blockPtrs;
     Item* _root;
 
     int _currentAllocs;
     int _nAllocs;
     int _maxAllocs;
     int _nUntracked;
+    int _itemsPerBlock;
+    XMLBlockAllocator* _allocator;
 };
 
 
@@ -551,12 +596,18 @@ public:
     static const char* SkipWhiteSpace( const char* p, int* curLineNumPtr )	{
         TIXMLASSERT( p );
 
-        while( IsWhiteSpace(*p) ) {
+        // Most runs are empty or a single space between attributes: only
+        // longer runs go to the vectorized scanner.
+        if ( !IsWhiteSpace(*p) ) {
+            return p;
+        }
+        if ( !IsWhiteSpace(*(p+1)) ) {
             if (curLineNumPtr && *p == '\n') {
                 ++(*curLineNumPtr);
             }
-            ++p;
+            return p + 1;
         }
+        p = SkipWhiteSpaceRun( p, curLineNumPtr );
         TIXMLASSERT( p );
         return p;
     }
@@ -637,6 +688,22 @@ public:
 	// Be sure to set static const memory as parameters.
 	static void SetBoolSerialization(const char* writeTrue, const char* writeFalse);
 
+    // Scanners used by the parser. They look at 16 (SSE2) or 32 (AVX2) bytes
+    // at a time when the processor supports it, chosen at run time, and fall
+    // back to a byte loop otherwise. They may read past the terminating null,
+    // but never past the aligned block that holds it.
+    // Returns the first byte that is not white space, counting the newlines skipped.
+    static const char* SkipWhiteSpaceRun( const char* p, int* curLineNumPtr );
+    // Returns the first byte equal to a, b, c or null, counting the newlines skipped.
+    static const char* FindOneOf( const char* p, char a, char b, char c, int* curLineNumPtr );
+    // Returns the first byte that can not be part of a name.
+    static const char* SkipNameChars( const char* p );
+    // Turns the vectorized scanners on (the default, when supported) or off.
+    // Static & not thread safe: call it before parsing.
+    static void SetSIMDEnabled( bool enabled );
+    // "avx2", "sse2" or "scalar": the scanners in use.
+    static const char* SIMDLevel();
+
 private:
 	static const char* writeBoolTrue;
 	static const char* writeBoolFalse;
@@ -1403,6 +1470,23 @@ public:
         return a->QueryFloatValue( value );
     }
 
+    /** Given several attribute names, reads them as floats in one pass over
+    	the attribute list. values[i] receives names[i]; values of attributes
+    	that are missing or not numbers are left unchanged.
+    	@code
+    	float xyz[3] = { 0, 0, 0 };
+    	vertex->QueryFloatAttributes( { "x", "y", "z" }, xyz );
+    	@endcode
+    	@return XML_SUCCESS if all were read, XML_WRONG_ATTRIBUTE_TYPE if one is
+    	not a number, otherwise XML_NO_ATTRIBUTE.
+    */
+    XMLError QueryFloatAttributes( const char* const* names, int count, float* values ) const;
+    /// See QueryFloatAttributes()
+    template< int N >
+    XMLError QueryFloatAttributes( const char* const (&names)[N], float* values ) const {
+        return QueryFloatAttributes( names, N, values );
+    }
+
 	/// See QueryIntAttribute()
 	XMLError QueryStringAttribute(const char* name, const char** value) const {
 		const XMLAttribute* a = FindAttribute(name);
@@ -1753,6 +1837,18 @@ public:
     */
     XMLError Parse( const char* xml, size_t nBytes=static_cast<size_t>(-1) );
 
+    /**
+    	Parse an XML document in place, without copying it. The parser
+    	writes into 'xml' (string terminators, entities, newlines) and the
+    	document's strings point into it, so the buffer must stay alive and
+    	untouched until the document is cleared, parsed again or deleted.
+    	xml[nBytes] must be writable: it is set to null.
+
+    	A file mapped copy-on-write (mmap with MAP_PRIVATE) makes a good
+    	buffer: the pages the parser does not write are never copied.
+    */
+    XMLError ParseInPlace( char* xml, size_t nBytes );
+
     /**
     	Load an XML file from disk.
     	Returns XML_SUCCESS (0) on success, or
@@ -1909,6 +2005,37 @@ public:
     /// Clear the document, resetting it to the initial state.
     void Clear();
 
+    /**
+    	Reusable-document mode, for parsing many files in sequence with
+    	the same document. Clear() (and so every Parse() or LoadFile())
+    	keeps the character buffer and reuses it if the next document fits.
+    	Pool blocks are always kept across Clear(): freed nodes go back to
+    	the pools and are handed out again. Call ReleaseMemory() to give
+    	the buffer and the blocks back.
+    */
+    void SetReuseBuffers( bool reuse )	{
+        _reuseBuffers = reuse;
+    }
+
+    /**
+    	Size in bytes of the blocks of the element and attribute pools
+    	(default 4k). Files with many small elements and attributes, such
+    	as long lists of vertices, parse with fewer allocations with larger
+    	blocks. Affects blocks allocated after the call.
+    */
+    void SetPoolBlockSize( int elementBytes, int attributeBytes );
+
+    /**
+    	Allocate pool blocks from an external arena instead of new[].
+    	Must be called before the first parse (or after ReleaseMemory()),
+    	and the allocator must outlive the document, or its last
+    	ReleaseMemory(). Pass null to go back to new[].
+    */
+    void SetBlockAllocator( XMLBlockAllocator* allocator );
+
+    /// Clear the document and free the character buffer and all pool blocks.
+    void ReleaseMemory();
+
 	/**
 		Copies this document to a target document.
 		The target will be completely cleared before the copy.
@@ -1935,6 +2062,8 @@ private:
     XMLDocument( const XMLDocument& );	// not supported
     void operator=( const XMLDocument& );	// not supported
 
+    void ReserveCharBuffer( size_t size );
+
     bool			_writeBOM;
     bool			_processEntities;
     XMLError		_errorID;
@@ -1942,6 +2071,9 @@ private:
     mutable StrPair	_errorStr;
     int             _errorLineNum;
     char*			_charBuffer;
+    size_t			_charBufferCapacity;
+    char*			_parseBuffer;	// _charBuffer, or the caller's buffer in ParseInPlace()
+    bool			_reuseBuffers;
     int				_parseCurLineNum;
 	int				_parsingDepth;
 	// Memory tracking does add some overhead.
@@ -2375,6 +2507,159 @@ private:
 };
 
 
+/**
+	A forward-only, streaming alternative to XMLDocument. Instead of
+	building a DOM, Next() returns one event at a time: the start of an
+	element (with its attributes), the end of an element, or text.
+
+	The input is read through a buffer that only grows when a single tag
+	or text does not fit in it, so documents larger than the available
+	memory can be read.
+
+	@verbatim
+	XMLPullParser parser;
+	parser.Open( "model.3d" );
+	XMLPullParser::Event event;
+	while ( ( event = parser.Next() ) != XMLPullParser::END_DOCUMENT ) {
+		if ( event == XMLPullParser::PARSE_ERROR ) {
+			break;
+		}
+		if ( event == XMLPullParser::START_ELEMENT && XMLUtil::StringEqual( parser.Name(), "vertex" ) ) {
+			float xyz[3] = { 0, 0, 0 };
+			parser.QueryFloatAttributes( { "x", "y", "z" }, xyz );
+		}
+	}
+	@endverbatim
+
+	Names, attribute values and text point into the buffer and are only
+	valid until the next call to Next(). An empty element (<a/>) gives a
+	START_ELEMENT followed by an END_ELEMENT.
+
+	Comments, processing instructions (<?xml ... ?>) and DOCTYPE are
+	skipped, and so is text made only of white space. CDATA sections are
+	returned as text. Entities, newlines and white space are processed as
+	in XMLDocument with PRESERVE_WHITESPACE. Errors are sticky: after
+	PARSE_ERROR every call to Next() returns PARSE_ERROR.
+*/
+class TINYXML2_LIB XMLPullParser
+{
+public:
+    enum Event {
+        START_ELEMENT,
+        END_ELEMENT,
+        TEXT,
+        END_DOCUMENT,
+        PARSE_ERROR
+    };
+
+    /// 'bufferSize' is the initial size of the read buffer.
+    XMLPullParser( size_t bufferSize = 64*1024, bool processEntities = true );
+    ~XMLPullParser();
+
+    /// Open a file for reading. Returns XML_SUCCESS or XML_ERROR_FILE_NOT_FOUND.
+    XMLError Open( const char* filename );
+    /// Read from an open file, from its current position. The file is not closed.
+    XMLError Open( FILE* fp );
+    /// Close the file (if it was opened by name). Next() then returns END_DOCUMENT.
+    void Close();
+
+    /// Read the next event.
+    Event Next();
+
+    /// Name of the element, for START_ELEMENT and END_ELEMENT.
+    const char* Name() const				{
+        return _name;
+    }
+    /// Content, for TEXT.
+    const char* Text() const				{
+        return _text;
+    }
+    /// Number of open elements, counting the one of a START_ELEMENT or END_ELEMENT.
+    int Depth() const						{
+        return _openOffsets.Size();
+    }
+    /// Line where the current event starts.
+    int LineNum() const						{
+        return _eventLineNum;
+    }
+
+    /// Number of attributes of a START_ELEMENT.
+    int AttributeCount() const				{
+        return _attributes.Size() / 2;
+    }
+    const char* AttributeName( int i ) const	{
+        return _attributes[2*i];
+    }
+    const char* AttributeValue( int i ) const	{
+        return _attributes[2*i+1];
+    }
+    /// Value of the named attribute of a START_ELEMENT, or null.
+    const char* Attribute( const char* name ) const;
+
+    /// See XMLElement::QueryIntAttribute()
+    XMLError QueryIntAttribute( const char* name, int* value ) const;
+    /// See XMLElement::QueryFloatAttribute()
+    XMLError QueryFloatAttribute( const char* name, float* value ) const;
+    /// See XMLElement::QueryFloatAttributes()
+    XMLError QueryFloatAttributes( const char* const* names, int count, float* values ) const;
+    /// See XMLElement::QueryFloatAttributes()
+    template< int N >
+    XMLError QueryFloatAttributes( const char* const (&names)[N], float* values ) const {
+        return QueryFloatAttributes( names, N, values );
+    }
+
+    bool Error() const						{
+        return _errorID != XML_SUCCESS;
+    }
+    XMLError ErrorID() const				{
+        return _errorID;
+    }
+    /// Line of the error, if any.
+    int ErrorLineNum() const				{
+        return _errorLineNum;
+    }
+    /// Current size of the read buffer.
+    size_t BufferSize() const				{
+        return _capacity;
+    }
+
+private:
+    XMLPullParser( const XMLPullParser& );	// not supported
+    void operator=( const XMLPullParser& );	// not supported
+
+    bool Fill();
+    void Ensure( size_t count );
+    char* Scan( size_t offset, const char* endTag );
+    void Consume( char* end );
+    Event StartElement( char* p, char* tagEnd );
+    Event EndElement( char* p, char* tagEnd );
+    Event CloseElement();
+    Event SetError( XMLError error );
+
+    FILE*	_fp;
+    bool	_ownsFile;
+    bool	_eof;
+    char*	_buffer;
+    size_t	_capacity;
+    size_t	_pos;				// first byte not consumed
+    size_t	_end;				// end of the data read; _buffer[_end] is null
+    bool	_processEntities;
+    bool	_pendingEnd;		// the last START_ELEMENT was an empty element
+    bool	_popPending;		// the last END_ELEMENT is still on the open element stack
+    bool	_tagAtPos;			// the '<' at _pos was replaced by the null ending the last text
+    XMLError _errorID;
+    int		_errorLineNum;
+    int		_lineNum;
+    int		_eventLineNum;
+    const char* _name;
+    const char* _text;
+
+    DynArray< const char*, 32 > _attributes;	// name, value, name, value...
+    DynArray< char, 256 > _openNames;			// names of the open elements, each null terminated
+    DynArray< int, 32 > _openOffsets;			// start of each name in _openNames
+};
+
+
 }	// tinyxml2
 
 #if defined(_MSC_VER)
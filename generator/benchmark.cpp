@@ -0,0 +1,158 @@
+#include "benchmark.h"
+#include "log.h"
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/// Resolução (slices = stacks) do modelo mais simples
+const int BENCHMARK_BASE_RESOLUTION = 4;
+/// Diferença de resolução entre modelos consecutivos
+const int BENCHMARK_RESOLUTION_STEP = 2;
+
+
+/**
+ * @class BenchmarkWriter
+ * @brief Escreve a hierarquia de grupos recursivamente, acumulando as contagens.
+ *
+ * Usa diretamente a saída do std::mt19937 (especificado pela norma) para
+ * que a cena seja igual em qualquer plataforma.
+ */
+class BenchmarkWriter {
+public:
+    BenchmarkWriter(ofstream& out, const BenchmarkParams& params, BenchmarkStats& stats)
+        : out(out), params(params), stats(stats), rng(params.seed), used(params.distinctModels, false) {}
+
+    void writeGroup(int level, const string& indent);
+
+private:
+    ofstream& out;
+    const BenchmarkParams& params;
+    BenchmarkStats& stats;
+    mt19937 rng;
+    vector<bool> used;
+
+    // Número uniforme em [0, 1)
+    double uniform() { return rng() / 4294967296.0; }
+};
+
+static int modelResolution(int model) {
+    return BENCHMARK_BASE_RESOLUTION + model * BENCHMARK_RESOLUTION_STEP;
+}
+
+void BenchmarkWriter::writeGroup(int level, const string& indent) {
+    stats.groups++;
+    out << indent << "<group>\n";
+
+    // Transformação: posição num anel à volta do pai, com escala decrescente
+    out << indent << "    <transform>\n";
+    bool animated = uniform() < params.animatedFraction;
+    float angle = (float)(uniform() * 360);
+    float distance = level == 0 ? 0 : (float)(2 + uniform() * 3);
+
+    if (animated) {
+        stats.animated++;
+        if (rng() % 2 == 0) {
+            out << indent << "        <rotate time=\"" << (int)(5 + uniform() * 20) << "\" x=\"0\" y=\"1\" z=\"0\" />\n";
+            out << indent << "        <translate x=\"" << distance << "\" y=\"0\" z=\"0\" />\n";
+        } else {
+            out << indent << "        <translate time=\"" << (int)(5 + uniform() * 20) << "\" align=\"true\">\n";
+            for (int p = 0; p < 4; p++) {
+                out << indent << "            <point x=\"" << distance * (p == 0 ? 1 : p == 2 ? -1 : 0)
+                    << "\" y=\"0\" z=\"" << distance * (p == 1 ? 1 : p == 3 ? -1 : 0) << "\" />\n";
+            }
+            out << indent << "        </translate>\n";
+        }
+    } else {
+        out << indent << "        <rotate angle=\"" << angle << "\" x=\"0\" y=\"1\" z=\"0\" />\n";
+        out << indent << "        <translate x=\"" << distance << "\" y=\"0\" z=\"0\" />\n";
+    }
+    out << indent << "        <scale x=\"0.5\" y=\"0.5\" z=\"0.5\" />\n";
+    out << indent << "    </transform>\n";
+
+    // Modelo: escolhido ao acaso entre os distintos
+    int model = (int)(rng() % (unsigned int)params.distinctModels);
+    int resolution = modelResolution(model);
+    string name = "sphere_1_" + to_string(resolution) + "_" + to_string(resolution) + ".3d";
+
+    out << indent << "    <models>\n";
+    out << indent << "        <model file=\"" << name << "\" /> <!-- generator sphere 1 "
+        << resolution << " " << resolution << " " << name << " -->\n";
+    out << indent << "    </models>\n";
+
+    stats.models++;
+    stats.triangles += 2 * (size_t)resolution * resolution;
+    if (!used[model]) {
+        used[model] = true;
+        stats.distinctModels++;
+    }
+
+    if (level < params.depth) {
+        for (int child = 0; child < params.fanout; child++) {
+            writeGroup(level + 1, indent + "    ");
+        }
+    }
+
+    out << indent << "</group>\n";
+}
+
+bool generateBenchmarkScene(const string& path, const BenchmarkParams& params, BenchmarkStats& stats) {
+    if (params.depth < 0 || params.fanout < 0 || params.distinctModels < 1 || params.lights < 0) {
+        LogLine(cerr) << "Parâmetros de cena inválidos";
+        return false;
+    }
+
+    ofstream out(path);
+    if (!out.is_open()) {
+        LogLine(cerr) << "Erro ao abrir o ficheiro: " << path;
+        return false;
+    }
+
+    stats = BenchmarkStats();
+
+    out << "<world>\n";
+    out << "    <window width=\"800\" height=\"600\" />\n";
+    out << "    <camera>\n";
+    out << "        <position x=\"20\" y=\"20\" z=\"20\" />\n";
+    out << "        <lookAt x=\"0\" y=\"0\" z=\"0\" />\n";
+    out << "        <up x=\"0\" y=\"1\" z=\"0\" />\n";
+    out << "        <projection fov=\"60\" near=\"1\" far=\"1000\" />\n";
+    out << "    </camera>\n";
+
+    if (params.lights > 0) {
+        out << "    <lights>\n";
+        for (int i = 0; i < params.lights; i++) {
+            out << "        <light type=\"point\" posX=\"" << 10 * (i % 3 - 1) << "\" posY=\"10\" posZ=\""
+                << 10 * (i / 3 % 3 - 1) << "\" />\n";
+        }
+        out << "    </lights>\n";
+        stats.lights = params.lights;
+    }
+
+    BenchmarkWriter writer(out, params, stats);
+    writer.writeGroup(0, "    ");
+    out << "</world>\n";
+    out.close();
+
+    // Manifesto com as contagens esperadas
+    ofstream manifest(path + ".manifest");
+    if (!manifest.is_open()) {
+        LogLine(cerr) << "Erro ao abrir o ficheiro: " << path << ".manifest";
+        return false;
+    }
+
+    manifest << "depth=" << params.depth << "\n"
+             << "fanout=" << params.fanout << "\n"
+             << "seed=" << params.seed << "\n"
+             << "groups=" << stats.groups << "\n"
+             << "models=" << stats.models << "\n"
+             << "distinct_models=" << stats.distinctModels << "\n"
+             << "triangles=" << stats.triangles << "\n"
+             << "animated=" << stats.animated << "\n"
+             << "lights=" << stats.lights << "\n";
+
+    return (bool)out && (bool)manifest;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @struct BenchmarkParams
+ * @brief Parâmetros de uma cena sintética para testes de escala.
+ */
+struct BenchmarkParams {
+    int depth = 3;                ///< Níveis de grupos abaixo da raiz
+    int fanout = 4;               ///< Grupos filho por grupo
+    int distinctModels = 4;       ///< Modelos diferentes (os restantes são repetições)
+    float animatedFraction = 0;   ///< Fração de grupos com transformações temporizadas
+    int lights = 0;               ///< Número de luzes
+    unsigned int seed = 1;        ///< Semente do gerador pseudo-aleatório
+};
+
+/**
+ * @struct BenchmarkStats
+ * @brief Contagens esperadas da cena gerada, escritas no manifesto.
+ */
+struct BenchmarkStats {
+    size_t groups = 0;            ///< Número de elementos <group>
+    size_t models = 0;            ///< Número de elementos <model>
+    size_t distinctModels = 0;    ///< Ficheiros .3d diferentes referenciados
+    size_t triangles = 0;         ///< Triângulos desenhados por frame
+    size_t animated = 0;          ///< Grupos com translate/rotate temporizados
+    size_t lights = 0;            ///< Número de luzes
+};
+
+/**
+ * @brief Gera uma cena XML sintética com a hierarquia <world><group><transform>.
+ *
+ * Cada grupo tem uma transformação e um modelo, e os grupos até à
+ * profundidade indicada têm fanout filhos. Os modelos são esferas de
+ * resolução diferente, referenciadas como sphere_1_N_N.3d (na mesma pasta
+ * da cena) e acompanhadas do comentário "generator sphere ...", pelo que
+ * "generator --scene" gera os ficheiros necessários.
+ *
+ * A mesma semente produz sempre a mesma cena. Ao lado da cena é escrito
+ * "<path>.manifest" com as contagens esperadas (BenchmarkStats).
+ *
+ * @param path Caminho do ficheiro XML de saída
+ * @param params Parâmetros da cena
+ * @param stats Recebe as contagens da cena
+ *
+ * @return true se a cena e o manifesto foram escritos
+ */
+bool generateBenchmarkScene(const std::string& path, const BenchmarkParams& params, BenchmarkStats& stats);
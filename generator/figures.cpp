@@ -0,0 +1,252 @@
+#include "figures.h"
+#include <cmath>
+#include <map>
+#include <utility>
+
+using namespace std;
+
+unsigned int Mesh::addVertex(float x, float y, float z) {
+    vertices.push_back(x);
+    vertices.push_back(y);
+    vertices.push_back(z);
+    return (unsigned int)(vertices.size() / 3 - 1);
+}
+
+void Mesh::addTriangle(unsigned int a, unsigned int b, unsigned int c) {
+    indices.push_back(a);
+    indices.push_back(b);
+    indices.push_back(c);
+}
+
+//Plano
+Mesh buildPlane(float length, int divisions) {
+    Mesh mesh;
+
+    float step = length / divisions;
+    float start = -length / 2;
+
+    // Grelha de (divisions + 1)^2 vértices
+    for (int i = 0; i <= divisions; i++) {
+        for (int j = 0; j <= divisions; j++) {
+            mesh.addVertex(start + j * step, 0, start + i * step);
+        }
+    }
+
+    int row = divisions + 1;
+    for (int i = 0; i < divisions; i++) {
+        for (int j = 0; j < divisions; j++) {
+            unsigned int p1 = i * row + j;
+            unsigned int p2 = i * row + j + 1;
+            unsigned int p3 = (i + 1) * row + j;
+            unsigned int p4 = (i + 1) * row + j + 1;
+
+            mesh.addTriangle(p1, p3, p2);
+            mesh.addTriangle(p2, p3, p4);
+        }
+    }
+
+    return mesh;
+}
+
+//Cubo
+Mesh buildBox(float size, int divisions) {
+    Mesh mesh;
+
+    float halfSize = size / 2.0f;
+    float step = size / divisions;
+    int row = divisions + 1;
+
+    for (int face = 0; face < 6; face++) {
+        unsigned int base = (unsigned int)mesh.vertexCount();
+
+        // Grelha da face: (u, v) percorre [-halfSize, halfSize]
+        for (int i = 0; i <= divisions; i++) {
+            for (int j = 0; j <= divisions; j++) {
+                float u = -halfSize + j * step;
+                float v = -halfSize + i * step;
+
+                switch (face) {
+                    case 0: mesh.addVertex(u, v, halfSize); break;   // Front face (Z = halfSize)
+                    case 1: mesh.addVertex(u, v, -halfSize); break;  // Back face (Z = -halfSize)
+                    case 2: mesh.addVertex(u, halfSize, v); break;   // Top face (Y = halfSize)
+                    case 3: mesh.addVertex(u, -halfSize, v); break;  // Bottom face (Y = -halfSize)
+                    case 4: mesh.addVertex(-halfSize, v, u); break;  // Left face (X = -halfSize)
+                    case 5: mesh.addVertex(halfSize, v, u); break;   // Right face (X = halfSize)
+                }
+            }
+        }
+
+        // Faces opostas percorrem a grelha ao contrário para manter a orientação
+        bool flipU = face == 1 || face == 4;
+        bool flipV = face == 2;
+
+        for (int i = 0; i < divisions; i++) {
+            for (int j = 0; j < divisions; j++) {
+                int c1 = flipU ? j + 1 : j, c2 = flipU ? j : j + 1;
+                int r1 = flipV ? i + 1 : i, r2 = flipV ? i : i + 1;
+
+                unsigned int p1 = base + r1 * row + c1;
+                unsigned int p2 = base + r1 * row + c2;
+                unsigned int p3 = base + r2 * row + c1;
+                unsigned int p4 = base + r2 * row + c2;
+
+                mesh.addTriangle(p1, p3, p2);
+                mesh.addTriangle(p2, p3, p4);
+            }
+        }
+    }
+
+    return mesh;
+}
+
+//Esfera
+Mesh buildSphere(float radius, int slices, int stacks) {
+    Mesh mesh;
+
+    // Grelha de (stacks + 1) x (slices + 1) vértices; a costura e os polos são duplicados
+    for (int i = 0; i <= stacks; i++) {
+        float theta = M_PI * i / stacks;
+
+        for (int j = 0; j <= slices; j++) {
+            float phi = 2 * M_PI * j / slices;
+
+            mesh.addVertex(radius * sin(theta) * cos(phi),
+                           radius * cos(theta),
+                           radius * sin(theta) * sin(phi));
+        }
+    }
+
+    int row = slices + 1;
+    for (int i = 0; i < stacks; i++) {
+        for (int j = 0; j < slices; j++) {
+            unsigned int p1 = i * row + j;
+            unsigned int p2 = i * row + j + 1;
+            unsigned int p3 = (i + 1) * row + j;
+            unsigned int p4 = (i + 1) * row + j + 1;
+
+            mesh.addTriangle(p1, p3, p2);
+            mesh.addTriangle(p2, p3, p4);
+        }
+    }
+
+    return mesh;
+}
+
+//Cone
+Mesh buildCone(float radius, float height, int slices, int stacks) {
+    Mesh mesh;
+
+    // Anéis laterais 0..stacks-1; o último stack fecha no vértice do cone
+    int row = slices + 1;
+    for (int i = 0; i < stacks; i++) {
+        float y = height * i / stacks;
+        float r = radius * (1 - y / height);
+
+        for (int j = 0; j <= slices; j++) {
+            float theta = 2 * M_PI * j / slices;
+            mesh.addVertex(r * cos(theta), y, r * sin(theta));
+        }
+    }
+    unsigned int apex = mesh.addVertex(0, height, 0);
+
+    for (int i = 0; i < stacks; i++) {
+        for (int j = 0; j < slices; j++) {
+            unsigned int p1 = i * row + j;
+            unsigned int p2 = i * row + j + 1;
+
+            if (i == stacks - 1) {
+                mesh.addTriangle(p1, p2, apex);
+            } else {
+                unsigned int p3 = (i + 1) * row + j;
+                unsigned int p4 = (i + 1) * row + j + 1;
+
+                mesh.addTriangle(p1, p2, p3);
+                mesh.addTriangle(p2, p4, p3);
+            }
+        }
+    }
+
+    // Base do cone: triângulos ligados ao centro
+    unsigned int center = mesh.addVertex(0, 0, 0);
+    unsigned int ring = (unsigned int)mesh.vertexCount();
+    for (int j = 0; j <= slices; j++) {
+        float theta = 2 * M_PI * j / slices;
+        mesh.addVertex(radius * cos(theta), 0, radius * sin(theta));
+    }
+
+    for (int j = 0; j < slices; j++) {
+        mesh.addTriangle(center, ring + j, ring + j + 1);
+    }
+
+    return mesh;
+}
+
+//Icosfera
+// Ponto médio da aresta (a, b) projetado na esfera. A cache garante que cada
+// aresta partilhada entre dois triângulos gera um único vértice.
+static unsigned int midpointIcosphere(unsigned int a, unsigned int b, Mesh& mesh,
+                                      map<pair<unsigned int, unsigned int>, unsigned int>& cache,
+                                      float radius) {
+    pair<unsigned int, unsigned int> key = a < b ? make_pair(a, b) : make_pair(b, a);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    const vector<float>& v = mesh.vertices;
+    float x = (v[3 * a] + v[3 * b]) / 2;
+    float y = (v[3 * a + 1] + v[3 * b + 1]) / 2;
+    float z = (v[3 * a + 2] + v[3 * b + 2]) / 2;
+    float length = sqrt(x * x + y * y + z * z);
+
+    unsigned int index = mesh.addVertex(x * radius / length, y * radius / length, z * radius / length);
+    cache[key] = index;
+    return index;
+}
+
+Mesh buildIcosphere(float radius, int subdivisions) {
+    Mesh mesh;
+
+    // Icosaedro inicial: 12 vértices e 20 faces
+    float t = (1 + sqrt(5.0f)) / 2;
+    float base[12][3] = {
+        {-1,  t,  0}, { 1,  t,  0}, {-1, -t,  0}, { 1, -t,  0},
+        { 0, -1,  t}, { 0,  1,  t}, { 0, -1, -t}, { 0,  1, -t},
+        { t,  0, -1}, { t,  0,  1}, {-t,  0, -1}, {-t,  0,  1}
+    };
+
+    for (int i = 0; i < 12; i++) {
+        float length = sqrt(base[i][0] * base[i][0] + base[i][1] * base[i][1] + base[i][2] * base[i][2]);
+        mesh.addVertex(base[i][0] * radius / length,
+                       base[i][1] * radius / length,
+                       base[i][2] * radius / length);
+    }
+
+    mesh.indices = {
+        0, 11, 5,   0, 5, 1,    0, 1, 7,    0, 7, 10,   0, 10, 11,
+        1, 5, 9,    5, 11, 4,   11, 10, 2,  10, 7, 6,   7, 1, 8,
+        3, 9, 4,    3, 4, 2,    3, 2, 6,    3, 6, 8,    3, 8, 9,
+        4, 9, 5,    2, 4, 11,   6, 2, 10,   8, 6, 7,    9, 8, 1
+    };
+
+    for (int s = 0; s < subdivisions; s++) {
+        map<pair<unsigned int, unsigned int>, unsigned int> cache;
+        vector<unsigned int> previous;
+        previous.swap(mesh.indices);
+        mesh.indices.reserve(previous.size() * 4);
+
+        for (size_t i = 0; i < previous.size(); i += 3) {
+            unsigned int a = previous[i], b = previous[i + 1], c = previous[i + 2];
+            unsigned int ab = midpointIcosphere(a, b, mesh, cache, radius);
+            unsigned int bc = midpointIcosphere(b, c, mesh, cache, radius);
+            unsigned int ca = midpointIcosphere(c, a, mesh, cache, radius);
+
+            mesh.addTriangle(a, ab, ca);
+            mesh.addTriangle(b, bc, ab);
+            mesh.addTriangle(c, ca, bc);
+            mesh.addTriangle(ab, bc, ca);
+        }
+    }
+
+    return mesh;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct Mesh
+ * @brief Malha indexada gerada em memória.
+ *
+ * Os vértices são guardados como triplos (x, y, z) consecutivos e cada
+ * triângulo como 3 índices para esse array, em sentido anti-horário
+ * visto do exterior.
+ */
+struct Mesh {
+    std::vector<float> vertices;        ///< Coordenadas x, y, z de cada vértice
+    std::vector<unsigned int> indices;  ///< 3 índices por triângulo
+
+    /// @brief Número de vértices da malha
+    size_t vertexCount() const { return vertices.size() / 3; }
+    /// @brief Número de triângulos da malha
+    size_t triangleCount() const { return indices.size() / 3; }
+
+    /// @brief Acrescenta um vértice e devolve o seu índice
+    unsigned int addVertex(float x, float y, float z);
+    /// @brief Acrescenta o triângulo (a, b, c)
+    void addTriangle(unsigned int a, unsigned int b, unsigned int c);
+};
+
+/**
+ * @brief Gera um plano no plano XZ, centrado na origem.
+ *
+ * @param length Comprimento do lado
+ * @param divisions Número de divisões em cada eixo
+ */
+Mesh buildPlane(float length, int divisions);
+
+/**
+ * @brief Gera um cubo centrado na origem.
+ *
+ * @param size Comprimento da aresta
+ * @param divisions Número de divisões em cada eixo de cada face
+ */
+Mesh buildBox(float size, int divisions);
+
+/**
+ * @brief Gera uma esfera UV centrada na origem.
+ *
+ * @param radius Raio
+ * @param slices Divisões em torno do eixo Y
+ * @param stacks Divisões ao longo do eixo Y
+ */
+Mesh buildSphere(float radius, int slices, int stacks);
+
+/**
+ * @brief Gera um cone com a base em Y=0 e o vértice em Y=height.
+ *
+ * @param radius Raio da base
+ * @param height Altura
+ * @param slices Divisões em torno do eixo Y
+ * @param stacks Divisões ao longo do eixo Y
+ */
+Mesh buildCone(float radius, float height, int slices, int stacks);
+
+/**
+ * @brief Gera uma icosfera por subdivisão de um icosaedro.
+ *
+ * Cada subdivisão parte cada triângulo em 4 usando os pontos médios das
+ * arestas; uma cache por aresta garante que vértices partilhados são criados
+ * uma única vez.
+ *
+ * @param radius Raio
+ * @param subdivisions Número de subdivisões
+ */
+Mesh buildIcosphere(float radius, int subdivisions);
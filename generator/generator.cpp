@@ -3,10 +3,28 @@
 #include <cmath>
 #include <string>
 #include <filesystem>
+#include "figures.h"
+#include "optimizer.h"
+#include "quantize.h"
+#include "simplify.h"
+#include "terrain.h"
+#include "benchmark.h"
+#include "log.h"
+#include <vector>
+#include <map>
+#include <tuple>
+#include <sstream>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
 
 using namespace std;
 namespace fs = std::filesystem;
 
+// Versão da geometria produzida. Deve ser incrementada sempre que algum gerador
+// mudar de forma a invalidar os ficheiros .stamp já existentes.
+const string GENERATOR_VERSION = "2";
+
 string caminhoFicheiro(const string& filename) {
     string dirPath = "files3d";
     
@@ -18,343 +36,632 @@ string caminhoFicheiro(const string& filename) {
     return dirPath + "/" + filename;
 }
 
-//Plano
-void generatePlane(float length, int divisions, const string& filename) {
+// Opções de escrita dos modelos, ativadas por prefixos no comando
+struct OutputOptions {
+    bool optimize = false;  // --optimize: reordenar para a cache de vértices
+    bool compress = false;  // --compress: formato binário quantizado (3DQ1)
+};
+
+// Escreve a malha no formato .3d: cada triângulo com os seus 3 vértices,
+// ou no formato binário quantizado se options.compress estiver ativo.
+bool writeMesh(Mesh mesh, const string& tag, const string& filename, const OutputOptions& options) {
     string filePath = caminhoFicheiro(filename);
+
+    if (options.optimize) {
+        float acmrBefore, acmrAfter;
+        optimizeMesh(mesh, &acmrBefore, &acmrAfter);
+        LogLine(cout) << "ACMR " << filename << ": " << acmrBefore << " -> " << acmrAfter;
+    }
     
-    ofstream file(filePath);
+    ofstream file(filePath, ios::binary);
     if (!file.is_open()) {
-        cerr << "Erro ao abrir o ficheiro: " << filePath << endl;
-        return;
-    }
-
-    file << "<plane>\n";
-
-    float step = length / divisions;
-    float start = -length / 2;
-
-    for (int i = 0; i < divisions; i++) {
-        for (int j = 0; j < divisions; j++) {
-            float x1 = start + j * step;
-            float z1 = start + i * step;
-            float x2 = start + (j + 1) * step;
-            float z2 = start + i * step;
-            float x3 = start + j * step;
-            float z3 = start + (i + 1) * step;
-            float x4 = start + (j + 1) * step;
-            float z4 = start + (i + 1) * step;
-
-            // Triângulo 1
-            file << "  <triangle>\n";
-            file << "    <vertex x='" << x1 << "' y='0' z='" << z1 << "'/>\n";
-            file << "    <vertex x='" << x3 << "' y='0' z='" << z3 << "'/>\n";
-            file << "    <vertex x='" << x2 << "' y='0' z='" << z2 << "'/>\n";
-            file << "  </triangle>\n";
-
-            // Triângulo 2
-            file << "  <triangle>\n";
-            file << "    <vertex x='" << x2 << "' y='0' z='" << z2 << "'/>\n";
-            file << "    <vertex x='" << x3 << "' y='0' z='" << z3 << "'/>\n";
-            file << "    <vertex x='" << x4 << "' y='0' z='" << z4 << "'/>\n";
-            file << "  </triangle>\n";
+        LogLine(cerr) << "Erro ao abrir o ficheiro: " << filePath;
+        return false;
+    }
+
+    if (options.compress) {
+        vector<unsigned char> data = encodeQuantizedMesh(mesh);
+        file.write((const char*)data.data(), data.size());
+        file.close();
+
+        LogLine(cout) << "Ficheiro guardado em: " << filePath << " (" << mesh.vertexCount()
+                      << " vértices, " << mesh.triangleCount() << " triângulos, "
+                      << data.size() << " bytes)";
+        return true;
+    }
+
+    file << "<" << tag << ">\n";
+
+    const vector<float>& v = mesh.vertices;
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        file << "  <triangle>\n";
+        for (int k = 0; k < 3; k++) {
+            unsigned int index = mesh.indices[i + k];
+            file << "    <vertex x='" << v[3 * index] << "' y='" << v[3 * index + 1]
+                 << "' z='" << v[3 * index + 2] << "'/>\n";
         }
+        file << "  </triangle>\n";
     }
 
-    file << "</plane>\n";
+    file << "</" << tag << ">\n";
     file.close();
     
-    cout << "Ficheiro guardado em: " << filePath << endl;
+    LogLine(cout) << "Ficheiro guardado em: " << filePath << " (" << mesh.vertexCount()
+                  << " vértices, " << mesh.triangleCount() << " triângulos)";
+    return true;
 }
 
-//Cubo
-void generateBox(float size, int divisions, const string& filename) {
-    string filePath = caminhoFicheiro(filename);
-    
-    ofstream file(filePath);
+// Lê um ficheiro .3d (texto ou quantizado). O formato de texto repete os
+// vértices de cada triângulo, pelo que os vértices com a mesma posição são
+// fundidos para que a malha tenha conectividade (e não há costuras a guardar).
+// O formato quantizado é indexado e mantém os vértices duplicados das costuras,
+// que o simplificador preserva. tag recebe o elemento raiz.
+bool readMesh(const string& path, Mesh& mesh, string& tag) {
+    ifstream file(path, ios::binary);
     if (!file.is_open()) {
-        cerr << "Erro ao abrir o ficheiro: " << filePath << endl;
-        return;
-    }
-
-    file << "<box>\n";
-
-    float halfSize = size / 2.0f;
-    float step = size / divisions;
-
-    for (int face = 0; face < 6; face++) {
-        for (int i = 0; i < divisions; i++) {
-            for (int j = 0; j < divisions; j++) {
-                float x1, y1, z1, x2, y2, z2, x3, y3, z3, x4, y4, z4;
-                
-                // Calcula
-                float u1 = -halfSize + j * step;
-                float u2 = -halfSize + (j + 1) * step;
-                float v1 = -halfSize + i * step;
-                float v2 = -halfSize + (i + 1) * step;
-                
-                // Define vertices
-                switch (face) {
-                    case 0: // Front face (Z = halfSize)
-                        x1 = u1; y1 = v1; z1 = halfSize;
-                        x2 = u2; y2 = v1; z2 = halfSize;
-                        x3 = u1; y3 = v2; z3 = halfSize;
-                        x4 = u2; y4 = v2; z4 = halfSize;
-                        break;
-                    case 1: // Back face (Z = -halfSize)
-                        x1 = u2; y1 = v1; z1 = -halfSize;
-                        x2 = u1; y2 = v1; z2 = -halfSize;
-                        x3 = u2; y3 = v2; z3 = -halfSize;
-                        x4 = u1; y4 = v2; z4 = -halfSize;
-                        break;
-                    case 2: // Top face (Y = halfSize)
-                        x1 = u1; y1 = halfSize; z1 = v2;
-                        x2 = u2; y2 = halfSize; z2 = v2;
-                        x3 = u1; y3 = halfSize; z3 = v1;
-                        x4 = u2; y4 = halfSize; z4 = v1;
-                        break;
-                    case 3: // Bottom face (Y = -halfSize)
-                        x1 = u1; y1 = -halfSize; z1 = v1;
-                        x2 = u2; y2 = -halfSize; z2 = v1;
-                        x3 = u1; y3 = -halfSize; z3 = v2;
-                        x4 = u2; y4 = -halfSize; z4 = v2;
-                        break;
-                    case 4: // Left face (X = -halfSize)
-                        x1 = -halfSize; y1 = v1; z1 = u2;
-                        x2 = -halfSize; y2 = v1; z2 = u1;
-                        x3 = -halfSize; y3 = v2; z3 = u2;
-                        x4 = -halfSize; y4 = v2; z4 = u1;
-                        break;
-                    case 5: // Right face (X = halfSize)
-                        x1 = halfSize; y1 = v1; z1 = u1;
-                        x2 = halfSize; y2 = v1; z2 = u2;
-                        x3 = halfSize; y3 = v2; z3 = u1;
-                        x4 = halfSize; y4 = v2; z4 = u2;
-                        break;
+        LogLine(cerr) << "Erro ao abrir o ficheiro: " << path;
+        return false;
+    }
+
+    string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    const unsigned char* bytes = (const unsigned char*)content.data();
+    if (isQuantizedMesh(bytes, content.size())) {
+        tag = "model";
+        return decodeQuantizedMesh(bytes, content.size(), mesh);
+    }
+
+    size_t open = content.find('<');
+    size_t end = content.find_first_of(" \t\r\n/>", open + 1);
+    if (open == string::npos || end == string::npos) {
+        LogLine(cerr) << "Ficheiro .3d inválido: " << path;
+        return false;
+    }
+    tag = content.substr(open + 1, end - open - 1);
+
+    map<tuple<float, float, float>, unsigned int> welded;
+    vector<unsigned int> triangle;
+    size_t pos = 0;
+
+    while ((pos = content.find("<vertex", pos)) != string::npos) {
+        size_t close = content.find('>', pos);
+        if (close == string::npos) {
+            break;
+        }
+
+        // Atributos x, y, z com aspas simples ou duplas
+        float coords[3] = {0, 0, 0};
+        const char* names[3] = {"x", "y", "z"};
+        for (int k = 0; k < 3; k++) {
+            for (size_t a = pos + 7; a < close; a++) {
+                if (content[a] == names[k][0] && (content[a - 1] == ' ' || content[a - 1] == '\t')) {
+                    size_t quote = content.find_first_of("'\"", a);
+                    if (quote < close) {
+                        coords[k] = strtof(content.c_str() + quote + 1, nullptr);
+                    }
+                    break;
                 }
+            }
+        }
+
+        auto key = make_tuple(coords[0], coords[1], coords[2]);
+        auto it = welded.find(key);
+        unsigned int index;
+        if (it == welded.end()) {
+            index = mesh.addVertex(coords[0], coords[1], coords[2]);
+            welded[key] = index;
+        } else {
+            index = it->second;
+        }
 
-                // Triangulo 1
-                file << "  <triangle>\n";
-                file << "    <vertex x='" << x1 << "' y='" << y1 << "' z='" << z1 << "'/>\n";
-                file << "    <vertex x='" << x3 << "' y='" << y3 << "' z='" << z3 << "'/>\n";
-                file << "    <vertex x='" << x2 << "' y='" << y2 << "' z='" << z2 << "'/>\n";
-                file << "  </triangle>\n";
-
-                // Triangulo 2
-                file << "  <triangle>\n";
-                file << "    <vertex x='" << x2 << "' y='" << y2 << "' z='" << z2 << "'/>\n";
-                file << "    <vertex x='" << x3 << "' y='" << y3 << "' z='" << z3 << "'/>\n";
-                file << "    <vertex x='" << x4 << "' y='" << y4 << "' z='" << z4 << "'/>\n";
-                file << "  </triangle>\n";
+        // Triângulos degenerados (ex.: nos polos da esfera) são descartados
+        triangle.push_back(index);
+        if (triangle.size() == 3) {
+            if (triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[0] != triangle[2]) {
+                mesh.addTriangle(triangle[0], triangle[1], triangle[2]);
             }
+            triangle.clear();
         }
+        pos = close;
     }
 
-    file << "</box>\n";
-    file.close();
-    
-    cout << "Ficheiro guardado em: " << filePath << endl;
+    return true;
 }
 
-//Esfera
-void generateSphere(float radius, int slices, int stacks, const string& filename) {
-    string filePath = caminhoFicheiro(filename);
-    
-    ofstream file(filePath);
-    if (!file.is_open()) {
-        cerr << "Erro ao abrir o ficheiro: " << filePath << endl;
-        return;
+// Nome do ficheiro de saída de um comando: o último argumento, exceto no
+// simplify, em que vem depois do ficheiro de entrada
+string outputName(const vector<string>& args) {
+    size_t first = 0;
+    while (first < args.size() && args[first].rfind("--", 0) == 0) {
+        first++;
+    }
+
+    if (first + 2 < args.size() && args[first] == "simplify") {
+        return args[first + 2];
+    }
+    return args.back();
+}
+
+// Ficheiro de entrada de um comando, tal como foi escrito: o modelo do
+// simplify ou a heightmap do terreno. Vazio se o comando não ler ficheiros.
+string inputName(const vector<string>& args) {
+    size_t first = 0;
+    while (first < args.size() && args[first].rfind("--", 0) == 0) {
+        first++;
     }
 
-    file << "<sphere>\n";
+    if (first + 2 < args.size() && args[first] == "simplify") {
+        return args[first + 1];
+    }
+    if (args.size() - first == 7 && args[first] == "terrain"
+        && args[first + 5].find_first_not_of("0123456789") != string::npos) {
+        return args[first + 5];
+    }
+    return "";
+}
+
+// O ficheiro de entrada pode ser indicado relativo a files3d
+string resolveInput(const string& input) {
+    if (!fs::exists(input) && fs::exists(caminhoFicheiro(input))) {
+        return caminhoFicheiro(input);
+    }
+    return input;
+}
 
-    for (int i = 0; i < stacks; i++) {
-        float theta1 = M_PI * i / stacks;
-        float theta2 = M_PI * (i + 1) / stacks;
+//Comando
+bool runCommand(const vector<string>& args, const OutputOptions& options);
+
+// Executa um único comando do gerador, ex.: {"sphere", "1", "10", "10", "sphere.3d"}.
+// Os prefixos "--optimize" e "--compress" ativam as OutputOptions correspondentes.
+bool runCommand(const vector<string>& args) {
+    OutputOptions options;
+    size_t first = 0;
+    for (; first < args.size() && args[first].rfind("--", 0) == 0; first++) {
+        if (args[first] == "--optimize") {
+            options.optimize = true;
+        } else if (args[first] == "--compress") {
+            options.compress = true;
+        } else {
+            break;
+        }
+    }
 
-        for (int j = 0; j < slices; j++) {
-            float phi1 = 2 * M_PI * j / slices;
-            float phi2 = 2 * M_PI * (j + 1) / slices;
+    return runCommand(vector<string>(args.begin() + first, args.end()), options);
+}
 
-            float x1 = radius * sin(theta1) * cos(phi1);
-            float y1 = radius * cos(theta1);
-            float z1 = radius * sin(theta1) * sin(phi1);
+bool runCommand(const vector<string>& args, const OutputOptions& options) {
+    if (args.empty()) {
+        LogLine(cout) << "Parâmetros inválidos.";
+        return false;
+    }
 
-            float x2 = radius * sin(theta1) * cos(phi2);
-            float y2 = radius * cos(theta1);
-            float z2 = radius * sin(theta1) * sin(phi2);
+    const string& shape = args[0];
 
-            float x3 = radius * sin(theta2) * cos(phi1);
-            float y3 = radius * cos(theta2);
-            float z3 = radius * sin(theta2) * sin(phi1);
+    if (shape == "sphere" && args.size() == 5) {
+        float radius = atof(args[1].c_str());
+        int slices = atoi(args[2].c_str());
+        int stacks = atoi(args[3].c_str());
+        string filename = args[4];
 
-            float x4 = radius * sin(theta2) * cos(phi2);
-            float y4 = radius * cos(theta2);
-            float z4 = radius * sin(theta2) * sin(phi2);
+        LogLine(cout) << "Gerando esfera: Raio=" << radius << ", Slices=" << slices
+                      << ", Stacks=" << stacks << ", Ficheiro=" << filename;
+
+        return writeMesh(buildSphere(radius, slices, stacks), "sphere", filename, options);
+    }
+    else if (shape == "plane" && args.size() == 4) {
+        float length = atof(args[1].c_str());
+        int divisions = atoi(args[2].c_str());
+        string filename = args[3];
+
+        LogLine(cout) << "Gerando plano: Comprimento=" << length << ", Divisões=" << divisions
+                      << ", Ficheiro=" << filename;
+
+        return writeMesh(buildPlane(length, divisions), "plane", filename, options);
+    }
+    else if (shape == "box" && args.size() == 4) {
+        float size = atof(args[1].c_str());
+        int divisions = atoi(args[2].c_str());
+        string filename = args[3];
+
+        LogLine(cout) << "Gerando cubo: Tamanho=" << size << ", Divisões=" << divisions
+                      << ", Ficheiro=" << filename;
+
+        return writeMesh(buildBox(size, divisions), "box", filename, options);
+    }
+    else if (shape == "cone" && args.size() == 6) {
+        float radius = atof(args[1].c_str());
+        float height = atof(args[2].c_str());
+        int slices = atoi(args[3].c_str());
+        int stacks = atoi(args[4].c_str());
+        string filename = args[5];
+
+        LogLine(cout) << "Gerando cone: Raio=" << radius << ", Altura=" << height
+                      << ", Slices=" << slices << ", Stacks=" << stacks
+                      << ", Ficheiro=" << filename;
+
+        return writeMesh(buildCone(radius, height, slices, stacks), "cone", filename, options);
+    }
+    else if (shape == "icosphere" && args.size() == 4) {
+        float radius = atof(args[1].c_str());
+        int subdivisions = atoi(args[2].c_str());
+        string filename = args[3];
 
-            // Triângulo 1
-            file << "  <triangle>\n";
-            file << "    <vertex x='" << x1 << "' y='" << y1 << "' z='" << z1 << "'/>\n";
-            file << "    <vertex x='" << x3 << "' y='" << y3 << "' z='" << z3 << "'/>\n";
-            file << "    <vertex x='" << x2 << "' y='" << y2 << "' z='" << z2 << "'/>\n";
-            file << "  </triangle>\n";
+        LogLine(cout) << "Gerando icosfera: Raio=" << radius << ", Subdivisões=" << subdivisions
+                      << ", Ficheiro=" << filename;
 
-            // Triângulo 2
-            file << "  <triangle>\n";
-            file << "    <vertex x='" << x2 << "' y='" << y2 << "' z='" << z2 << "'/>\n";
-            file << "    <vertex x='" << x3 << "' y='" << y3 << "' z='" << z3 << "'/>\n";
-            file << "    <vertex x='" << x4 << "' y='" << y4 << "' z='" << z4 << "'/>\n";
-            file << "  </triangle>\n";
+        return writeMesh(buildIcosphere(radius, subdivisions), "icosphere", filename, options);
+    }
+    else if (shape == "terrain" && args.size() == 7) {
+        TerrainParams params;
+        params.size = atof(args[1].c_str());
+        params.divisions = atoi(args[2].c_str());
+        params.chunkDivisions = atoi(args[3].c_str());
+        params.height = atof(args[4].c_str());
+        params.optimize = options.optimize;
+        string filename = args[6];
+
+        // O quinto parâmetro é a semente do ruído ou uma heightmap PGM
+        if (args[5].find_first_not_of("0123456789") == string::npos) {
+            params.seed = (unsigned int)strtoul(args[5].c_str(), nullptr, 10);
+        } else {
+            params.heightmap = args[5];
         }
+
+        LogLine(cout) << "Gerando terreno: Tamanho=" << params.size << ", Divisões=" << params.divisions
+                      << ", Divisões por bloco=" << params.chunkDivisions << ", Altura=" << params.height
+                      << ", " << (params.heightmap.empty() ? "Semente=" + args[5] : "Heightmap=" + args[5])
+                      << ", Ficheiro=" << filename;
+
+        string filePath = caminhoFicheiro(filename);
+        size_t chunks;
+        if (!generateTerrain(filePath, params, &chunks)) {
+            return false;
+        }
+
+        LogLine(cout) << "Ficheiro guardado em: " << filePath << " (" << chunks << " blocos)";
+        return true;
     }
+    else if (shape == "benchmark" && args.size() == 8) {
+        BenchmarkParams params;
+        params.depth = atoi(args[1].c_str());
+        params.fanout = atoi(args[2].c_str());
+        params.distinctModels = atoi(args[3].c_str());
+        params.animatedFraction = atof(args[4].c_str());
+        params.lights = atoi(args[5].c_str());
+        params.seed = (unsigned int)strtoul(args[6].c_str(), nullptr, 10);
+        string filename = args[7];
+
+        LogLine(cout) << "Gerando cena de teste: Profundidade=" << params.depth << ", Filhos=" << params.fanout
+                      << ", Modelos distintos=" << params.distinctModels << ", Animados=" << params.animatedFraction
+                      << ", Luzes=" << params.lights << ", Semente=" << params.seed
+                      << ", Ficheiro=" << filename;
+
+        string filePath = caminhoFicheiro(filename);
+        BenchmarkStats stats;
+        if (!generateBenchmarkScene(filePath, params, stats)) {
+            return false;
+        }
 
-    file << "</sphere>\n";
-    file.close();
-    
-    cout << "Ficheiro guardado em: " << filePath << endl;
+        LogLine(cout) << "Ficheiro guardado em: " << filePath << " (" << stats.groups << " grupos, "
+                      << stats.triangles << " triângulos)";
+        return true;
+    }
+    else if (shape == "simplify" && args.size() == 5 && (args[3] == "--ratio" || args[3] == "--error")) {
+        string input = args[1];
+        string filename = args[2];
+        float value = atof(args[4].c_str());
+
+        input = resolveInput(input);
+
+        Mesh mesh;
+        string tag;
+        if (!readMesh(input, mesh, tag)) {
+            return false;
+        }
+
+        // --ratio: fração de triângulos a manter; --error: erro quádrico máximo
+        size_t target = 0;
+        double maxError = -1;
+        if (args[3] == "--ratio") {
+            target = (size_t)(mesh.triangleCount() * value);
+        } else {
+            maxError = value;
+        }
+
+        LogLine(cout) << "Simplificando: " << input << " (" << mesh.triangleCount() << " triângulos), "
+                      << args[3].substr(2) << "=" << value << ", Ficheiro=" << filename;
+
+        double error;
+        Mesh simplified = simplifyMesh(mesh, target, maxError, &error);
+        LogLine(cout) << "Triângulos: " << mesh.triangleCount() << " -> " << simplified.triangleCount()
+                      << ", erro máximo=" << error;
+
+        return writeMesh(simplified, tag, filename, options);
+    }
+
+    LogLine(cout) << "Parâmetros inválidos.";
+    return false;
 }
 
-//Cone
-void generateCone(float radius, float height, int slices, int stacks, const string& filename) {
-    string filePath = caminhoFicheiro(filename);
-    
-    ofstream file(filePath);
-    if (!file.is_open()) {
-        cerr << "Erro ao abrir o ficheiro: " << filePath << endl;
-        return;
-    }
-
-    file << "<cone>\n";
-
-    // Generate lado do cone
-    for (int i = 0; i < stacks; i++) {
-        float y1 = height * i / stacks;
-        float y2 = height * (i + 1) / stacks;
-        
-        // Calcula raio
-        float r1 = radius * (1 - y1 / height);
-        float r2 = radius * (1 - y2 / height);
-
-        for (int j = 0; j < slices; j++) {
-            float theta1 = 2 * M_PI * j / slices;
-            float theta2 = 2 * M_PI * (j + 1) / slices;
-
-            float x1 = r1 * cos(theta1);
-            float z1 = r1 * sin(theta1);
-
-            float x2 = r1 * cos(theta2);
-            float z2 = r1 * sin(theta2);
-
-            if (i == stacks - 1) {
-                file << "  <triangle>\n";
-                file << "    <vertex x='" << x1 << "' y='" << y1 << "' z='" << z1 << "'/>\n";
-                file << "    <vertex x='" << x2 << "' y='" << y1 << "' z='" << z2 << "'/>\n";
-                file << "    <vertex x='0' y='" << height << "' z='0'/>\n";
-                file << "  </triangle>\n";
-            } else {
-
-                float x3 = r2 * cos(theta1);
-                float z3 = r2 * sin(theta1);
-                float x4 = r2 * cos(theta2);
-                float z4 = r2 * sin(theta2);
-
-                // Triangle 1
-                file << "  <triangle>\n";
-                file << "    <vertex x='" << x1 << "' y='" << y1 << "' z='" << z1 << "'/>\n";
-                file << "    <vertex x='" << x2 << "' y='" << y1 << "' z='" << z2 << "'/>\n";
-                file << "    <vertex x='" << x3 << "' y='" << y2 << "' z='" << z3 << "'/>\n";
-                file << "  </triangle>\n";
-
-                // Triangle 2
-                file << "  <triangle>\n";
-                file << "    <vertex x='" << x2 << "' y='" << y1 << "' z='" << z2 << "'/>\n";
-                file << "    <vertex x='" << x4 << "' y='" << y2 << "' z='" << z4 << "'/>\n";
-                file << "    <vertex x='" << x3 << "' y='" << y2 << "' z='" << z3 << "'/>\n";
-                file << "  </triangle>\n";
-            }
+//Stamps
+// Hash FNV-1a (64 bits) dos parâmetros do comando, da versão do gerador e do
+// conteúdo do ficheiro de entrada, se existir
+string commandHash(const vector<string>& args) {
+    unsigned long long hash = 14695981039346656037ULL;
+    auto mix = [&hash](const string& text) {
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
         }
+        hash ^= 0xff;
+        hash *= 1099511628211ULL;
+    };
+
+    mix(GENERATOR_VERSION);
+    for (const string& arg : args) {
+        mix(arg);
     }
 
-    // Generate the base of the cone
-    for (int j = 0; j < slices; j++) {
-        float theta1 = 2 * M_PI * j / slices;
-        float theta2 = 2 * M_PI * (j + 1) / slices;
+    string input = inputName(args);
+    if (!input.empty()) {
+        ifstream file(resolveInput(input), ios::binary);
+        mix(string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>()));
+    }
 
-        float x1 = radius * cos(theta1);
-        float z1 = radius * sin(theta1);
-        float x2 = radius * cos(theta2);
-        float z2 = radius * sin(theta2);
+    ostringstream out;
+    out << hex << hash;
+    return out.str();
+}
 
-        // Create triangle connecting points to center
-        file << "  <triangle>\n";
-        file << "    <vertex x='0' y='0' z='0'/>\n";
-        file << "    <vertex x='" << x1 << "' y='0' z='" << z1 << "'/>\n";
-        file << "    <vertex x='" << x2 << "' y='0' z='" << z2 << "'/>\n";
-        file << "  </triangle>\n";
+string caminhoStamp(const vector<string>& args) {
+    return caminhoFicheiro(outputName(args)) + ".stamp";
+}
+
+// Um ficheiro está atualizado se existir e o seu stamp tiver o mesmo hash
+bool upToDate(const vector<string>& args) {
+    if (!fs::exists(caminhoFicheiro(outputName(args)))) {
+        return false;
     }
 
-    file << "</cone>\n";
-    file.close();
-    
-    cout << "Ficheiro guardado em: " << filePath << endl;
+    ifstream stamp(caminhoStamp(args));
+    string hash;
+    return stamp >> hash && hash == commandHash(args);
 }
 
-//Main
-int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        cout << "Parâmetros inválidos." << endl;
-        return 1;
+bool runCommandWithStamp(const vector<string>& args) {
+    // Hash calculado antes de gerar: é esta a entrada que o ficheiro reflete
+    string hash = commandHash(args);
+    if (!runCommand(args)) {
+        return false;
     }
 
-    string shape = argv[1];
+    // Sem stamp o ficheiro seria gerado de novo em cada lote, sem aviso
+    ofstream stamp(caminhoStamp(args));
+    stamp << hash << "\n";
+    stamp.close();
+    if (stamp.fail()) {
+        LogLine(cerr) << "Erro ao escrever o stamp: " << caminhoStamp(args);
+        return false;
+    }
+    return true;
+}
+
+//Manifesto
+// Divide uma linha em argumentos, removendo o prefixo "generator" se existir
+vector<string> splitCommand(const string& line) {
+    istringstream in(line);
+    vector<string> args;
+    string token;
+    while (in >> token) {
+        args.push_back(token);
+    }
+
+    if (!args.empty() && args[0] == "generator") {
+        args.erase(args.begin());
+    }
+    return args;
+}
+
+// Manifesto: um comando por linha, linhas vazias e começadas por '#' são ignoradas
+bool readManifest(const string& path, vector<vector<string>>& commands) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        LogLine(cerr) << "Erro ao abrir o manifesto: " << path;
+        return false;
+    }
 
-    if (shape == "sphere" && argc == 6) {
-        float radius = atof(argv[2]);
-        int slices = atoi(argv[3]);
-        int stacks = atoi(argv[4]);
-        string filename = argv[5];
+    string line;
+    while (getline(file, line)) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == string::npos || line[start] == '#') {
+            continue;
+        }
 
-        cout << "Gerando esfera: Raio=" << radius << ", Slices=" << slices
-             << ", Stacks=" << stacks << ", Ficheiro=" << filename << endl;
+        vector<string> args = splitCommand(line);
+        if (!args.empty()) {
+            commands.push_back(args);
+        }
+    }
+    return true;
+}
 
-        generateSphere(radius, slices, stacks, filename);
+// Extrai os comentários <!-- generator ... --> de um ficheiro XML de cena
+bool readSceneCommands(const string& path, vector<vector<string>>& commands) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        LogLine(cerr) << "Erro ao abrir a cena: " << path;
+        return false;
     }
-    else if (shape == "plane" && argc == 5) {
-        float length = atof(argv[2]);
-        int divisions = atoi(argv[3]);
-        string filename = argv[4];
 
-        cout << "Gerando plano: Comprimento=" << length << ", Divisões=" << divisions
-             << ", Ficheiro=" << filename << endl;
+    string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
 
-        generatePlane(length, divisions, filename);
+    size_t pos = 0;
+    while ((pos = content.find("<!--", pos)) != string::npos) {
+        size_t end = content.find("-->", pos);
+        if (end == string::npos) {
+            break;
+        }
+
+        string comment = content.substr(pos + 4, end - pos - 4);
+        if (comment.find_first_not_of(" \t\r\n") == comment.find("generator")) {
+            vector<string> args = splitCommand(comment);
+            if (!args.empty()) {
+                commands.push_back(args);
+            }
+        }
+        pos = end + 3;
     }
-    else if (shape == "box" && argc == 5) {
-        float size = atof(argv[2]);
-        int divisions = atoi(argv[3]);
-        string filename = argv[4];
+    return true;
+}
+
+// Indica se o ficheiro de entrada input é o ficheiro de saída output
+bool sameFile(const string& input, const string& output) {
+    fs::path produced = fs::path(caminhoFicheiro(output)).lexically_normal();
+    return fs::path(input).lexically_normal() == produced
+        || fs::path(caminhoFicheiro(input)).lexically_normal() == produced;
+}
 
-        cout << "Gerando cubo: Tamanho=" << size << ", Divisões=" << divisions
-             << ", Ficheiro=" << filename << endl;
+// Gera em paralelo todos os modelos pedidos, saltando os que estão atualizados.
+// Um comando cuja entrada é a saída de outro (ex.: simplify de uma esfera do
+// mesmo manifesto) só corre depois desse, numa vaga seguinte.
+int runBatch(const vector<vector<string>>& commands) {
+    // Cada ficheiro de saída é gerado uma única vez
+    vector<vector<string>> unique;
+    map<string, vector<string>> byOutput;
+    for (const vector<string>& args : commands) {
+        string output = outputName(args);
+        auto it = byOutput.find(output);
+        if (it == byOutput.end()) {
+            byOutput[output] = args;
+            unique.push_back(args);
+        } else if (it->second != args) {
+            LogLine(cerr) << "Aviso: parâmetros diferentes para " << output << ", usado o primeiro";
+        }
+    }
 
-        generateBox(size, divisions, filename);
+    // Dependências: comandos que produzem o ficheiro de entrada de cada comando
+    vector<vector<size_t>> dependencies(unique.size());
+    for (size_t i = 0; i < unique.size(); i++) {
+        string input = inputName(unique[i]);
+        if (input.empty()) {
+            continue;
+        }
+        for (size_t j = 0; j < unique.size(); j++) {
+            if (j != i && sameFile(input, outputName(unique[j]))) {
+                dependencies[i].push_back(j);
+            }
+        }
     }
-    else if (shape == "cone" && argc == 7) {
-        float radius = atof(argv[2]);
-        float height = atof(argv[3]);
-        int slices = atoi(argv[4]);
-        int stacks = atoi(argv[5]);
-        string filename = argv[6];
 
-        cout << "Gerando cone: Raio=" << radius << ", Altura=" << height
-             << ", Slices=" << slices << ", Stacks=" << stacks
-             << ", Ficheiro=" << filename << endl;
+    enum State { PENDING, DONE, FAILED };
+    vector<State> state(unique.size(), PENDING);
+    atomic<int> generated(0), skipped(0), failed(0);
+
+    auto logError = [&](const vector<string>& args, const string& reason) {
+        LogLine(cerr) << "Erro no comando: " << args[0] << " ... " << outputName(args) << reason;
+    };
+
+    size_t pending = unique.size();
+    while (pending > 0) {
+        // Vaga: comandos pendentes cujas dependências já terminaram
+        vector<size_t> wave;
+        size_t skippedInputs = 0;
+        for (size_t i = 0; i < unique.size(); i++) {
+            if (state[i] != PENDING) {
+                continue;
+            }
 
-        generateCone(radius, height, slices, stacks, filename);
+            bool ready = true, blocked = false;
+            for (size_t j : dependencies[i]) {
+                ready = ready && state[j] != PENDING;
+                blocked = blocked || state[j] == FAILED;
+            }
+            if (blocked) {
+                state[i] = FAILED;
+                failed++;
+                pending--;
+                skippedInputs++;
+                logError(unique[i], " (a entrada falhou)");
+            } else if (ready) {
+                wave.push_back(i);
+            }
+        }
+
+        if (wave.empty()) {
+            if (skippedInputs > 0) {
+                continue;
+            }
+            // Só restam comandos que dependem uns dos outros
+            for (size_t i = 0; i < unique.size(); i++) {
+                if (state[i] == PENDING) {
+                    state[i] = FAILED;
+                    failed++;
+                    logError(unique[i], " (dependência circular)");
+                }
+            }
+            break;
+        }
+
+        atomic<size_t> next(0);
+        auto worker = [&]() {
+            size_t w;
+            while ((w = next++) < wave.size()) {
+                size_t i = wave[w];
+                const vector<string>& args = unique[i];
+                if (upToDate(args)) {
+                    skipped++;
+                    state[i] = DONE;
+                    continue;
+                }
+
+                if (runCommandWithStamp(args)) {
+                    generated++;
+                    state[i] = DONE;
+                } else {
+                    failed++;
+                    state[i] = FAILED;
+                    logError(args, "");
+                }
+            }
+        };
+
+        unsigned int threadCount = max(1u, thread::hardware_concurrency());
+        threadCount = min<unsigned int>(threadCount, wave.size());
+
+        vector<thread> threads;
+        for (unsigned int t = 1; t < threadCount; t++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (thread& t : threads) {
+            t.join();
+        }
+        pending -= wave.size();
     }
-    else {
-        cout << "Parâmetros inválidos." << endl;
+
+    LogLine(cout) << "Modelos: " << generated << " gerados, " << skipped << " atualizados, "
+                  << failed << " com erro";
+    return failed == 0 ? 0 : 1;
+}
+
+//Main
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        LogLine(cout) << "Parâmetros inválidos.";
         return 1;
     }
 
-    return 0;
-}
\ No newline at end of file
+    string mode = argv[1];
+
+    if ((mode == "--manifest" || mode == "--scene") && argc == 3) {
+        vector<vector<string>> commands;
+        bool ok = mode == "--manifest" ? readManifest(argv[2], commands)
+                                       : readSceneCommands(argv[2], commands);
+        if (!ok) {
+            return 1;
+        }
+        return runBatch(commands);
+    }
+
+    vector<string> args(argv + 1, argv + argc);
+    return runCommandWithStamp(args) ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <mutex>
+#include <ostream>
+#include <sstream>
+
+/// Mutex partilhado por todas as mensagens escritas com LogLine
+inline std::mutex logMutex;
+
+/**
+ * @class LogLine
+ * @brief Linha de mensagem escrita de uma só vez em cout ou cerr.
+ *
+ * O texto é acumulado e, no destrutor, escrito com o fim de linha sob
+ * logMutex, para que as mensagens de threads diferentes (ex.: os comandos
+ * de um lote) não se intercalem. Uso: LogLine(cout) << "Texto " << valor;
+ */
+class LogLine {
+public:
+    explicit LogLine(std::ostream& out) : out(out) {}
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    ~LogLine() {
+        std::lock_guard<std::mutex> lock(logMutex);
+        out << text.str() << std::endl;
+    }
+
+    template <typename T>
+    LogLine& operator<<(const T& value) {
+        text << value;
+        return *this;
+    }
+
+private:
+    std::ostream& out;        ///< Destino da linha
+    std::ostringstream text;  ///< Texto acumulado
+};
@@ -0,0 +1,224 @@
+#include "optimizer.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+/// Tamanho da cache LRU usada na pontuação do algoritmo de Forsyth
+const int FORSYTH_CACHE_SIZE = 32;
+/// Pontuação dos vértices do último triângulo emitido
+const float LAST_TRIANGLE_SCORE = 0.75f;
+/// Expoente do decaimento da pontuação com a posição na cache
+const float CACHE_DECAY_POWER = 1.5f;
+/// Peso do bónus para vértices com poucos triângulos por emitir
+const float VALENCE_BOOST_SCALE = 2.0f;
+/// Expoente do bónus de valência
+const float VALENCE_BOOST_POWER = 0.5f;
+
+
+float computeACMR(const vector<unsigned int>& indices, size_t vertexCount, int cacheSize) {
+    if (indices.empty()) {
+        return 0;
+    }
+
+    // Cada vértice guarda o instante em que entrou na cache FIFO
+    vector<long long> insertedAt(vertexCount, -1);
+    long long time = 0;
+    size_t misses = 0;
+
+    for (unsigned int index : indices) {
+        if (insertedAt[index] < 0 || time - insertedAt[index] >= cacheSize) {
+            insertedAt[index] = time++;
+            misses++;
+        }
+    }
+
+    return (float)misses / (indices.size() / 3);
+}
+
+static float vertexScore(int cachePosition, int remaining) {
+    // Vértices sem triângulos por emitir não contribuem
+    if (remaining == 0) {
+        return -1;
+    }
+
+    float score = 0;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            score = LAST_TRIANGLE_SCORE;
+        } else {
+            float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            score = pow(1.0f - (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+        }
+    }
+
+    return score + VALENCE_BOOST_SCALE * pow((float)remaining, -VALENCE_BOOST_POWER);
+}
+
+void optimizeVertexCache(vector<unsigned int>& indices, size_t vertexCount) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // Lista de adjacência vértice -> triângulos (offsets + array compacto)
+    vector<int> remaining(vertexCount, 0);
+    for (unsigned int index : indices) {
+        remaining[index]++;
+    }
+
+    vector<size_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+
+    vector<unsigned int> adjacency(indices.size());
+    vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) {
+            adjacency[fill[indices[3 * t + k]]++] = (unsigned int)t;
+        }
+    }
+
+    vector<int> cachePosition(vertexCount, -1);
+    vector<float> scores(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        scores[v] = vertexScore(-1, remaining[v]);
+    }
+
+    vector<float> triangleScores(triangleCount);
+    vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScores[t] = scores[indices[3 * t]] + scores[indices[3 * t + 1]] + scores[indices[3 * t + 2]];
+    }
+
+    vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    vector<unsigned int> cache, nextCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+    long long best = max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin();
+    size_t cursor = 0;
+
+    while (result.size() < indices.size()) {
+        // Sem candidatos na cache: continua no próximo triângulo por emitir
+        if (best < 0) {
+            while (emitted[cursor]) {
+                cursor++;
+            }
+            best = (long long)cursor;
+        }
+
+        const unsigned int* tri = &indices[3 * best];
+        emitted[best] = true;
+        result.insert(result.end(), tri, tri + 3);
+
+        // Remove o triângulo das listas de adjacência dos seus vértices
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = tri[k];
+            unsigned int* list = &adjacency[offsets[v]];
+            int count = remaining[v];
+            for (int i = 0; i < count; i++) {
+                if (list[i] == (unsigned int)best) {
+                    list[i] = list[count - 1];
+                    break;
+                }
+            }
+            remaining[v]--;
+        }
+
+        // Nova cache LRU: vértices do triângulo à frente, seguidos dos restantes
+        nextCache.assign(tri, tri + 3);
+        for (unsigned int v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                nextCache.push_back(v);
+            }
+        }
+
+        // Atualiza posições e pontuações dos vértices afetados
+        for (size_t i = 0; i < nextCache.size(); i++) {
+            unsigned int v = nextCache[i];
+            cachePosition[v] = i < (size_t)FORSYTH_CACHE_SIZE ? (int)i : -1;
+            float score = vertexScore(cachePosition[v], remaining[v]);
+            float delta = score - scores[v];
+            scores[v] = score;
+
+            for (size_t a = offsets[v]; a < offsets[v] + remaining[v]; a++) {
+                triangleScores[adjacency[a]] += delta;
+            }
+        }
+
+        if (nextCache.size() > (size_t)FORSYTH_CACHE_SIZE) {
+            nextCache.resize(FORSYTH_CACHE_SIZE);
+        }
+        cache.swap(nextCache);
+
+        // Próximo triângulo: o de maior pontuação entre os adjacentes à cache
+        best = -1;
+        float bestScore = -1;
+        for (unsigned int v : cache) {
+            for (size_t a = offsets[v]; a < offsets[v] + remaining[v]; a++) {
+                unsigned int t = adjacency[a];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(result);
+}
+
+vector<unsigned int> optimizeVertexFetch(vector<unsigned int>& indices, size_t vertexCount) {
+    const unsigned int UNUSED = ~0u;
+    vector<unsigned int> remap(vertexCount, UNUSED);
+    unsigned int next = 0;
+
+    for (unsigned int& index : indices) {
+        if (remap[index] == UNUSED) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+
+    for (unsigned int& target : remap) {
+        if (target == UNUSED) {
+            target = next++;
+        }
+    }
+
+    return remap;
+}
+
+void optimizeMesh(Mesh& mesh, float* acmrBefore, float* acmrAfter) {
+    size_t vertexCount = mesh.vertexCount();
+
+    float before = computeACMR(mesh.indices, vertexCount);
+    if (acmrBefore) {
+        *acmrBefore = before;
+    }
+
+    // Só troca a ordem dos triângulos se a reordenação melhorar o ACMR
+    vector<unsigned int> indices = mesh.indices;
+    optimizeVertexCache(indices, vertexCount);
+    if (computeACMR(indices, vertexCount) < before) {
+        mesh.indices.swap(indices);
+    }
+
+    vector<unsigned int> remap = optimizeVertexFetch(mesh.indices, vertexCount);
+
+    vector<float> vertices(mesh.vertices.size());
+    for (size_t v = 0; v < vertexCount; v++) {
+        for (int k = 0; k < 3; k++) {
+            vertices[3 * remap[v] + k] = mesh.vertices[3 * v + k];
+        }
+    }
+    mesh.vertices.swap(vertices);
+
+    if (acmrAfter) {
+        *acmrAfter = computeACMR(mesh.indices, vertexCount);
+    }
+}
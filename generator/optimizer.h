@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "figures.h"
+
+/**
+ * @brief Calcula o ACMR (average cache miss ratio) de uma lista de índices.
+ *
+ * Simula uma cache FIFO de vértices pós-transformação e devolve o número
+ * médio de vértices transformados por triângulo (1.0 no pior caso
+ * indexado, ~0.5 numa grelha ideal).
+ *
+ * @param indices 3 índices por triângulo
+ * @param vertexCount Número de vértices referenciados
+ * @param cacheSize Número de entradas da cache simulada
+ */
+float computeACMR(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize = 16);
+
+/**
+ * @brief Reordena os triângulos para localidade na cache de vértices.
+ *
+ * Implementa o algoritmo de Tom Forsyth ("Linear-Speed Vertex Cache
+ * Optimisation"): em cada passo emite o triângulo com maior pontuação,
+ * pontuando os vértices pela posição numa cache LRU e pelo número de
+ * triângulos que ainda os usam.
+ *
+ * @param indices 3 índices por triângulo, reordenados no próprio vetor
+ * @param vertexCount Número de vértices referenciados
+ */
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+/**
+ * @brief Renumera os vértices pela ordem do primeiro uso nos índices.
+ *
+ * Os índices são reescritos no próprio vetor. Vértices não referenciados
+ * ficam no fim.
+ *
+ * @param indices 3 índices por triângulo
+ * @param vertexCount Número de vértices
+ *
+ * @return Tabela de remapeamento: remap[antigo] = novo
+ */
+std::vector<unsigned int> optimizeVertexFetch(std::vector<unsigned int>& indices, size_t vertexCount);
+
+/**
+ * @brief Aplica optimizeVertexCache() e optimizeVertexFetch() a uma malha.
+ *
+ * @param mesh Malha a otimizar (índices e vértices são reordenados)
+ * @param acmrBefore Se não for nulo, recebe o ACMR antes da otimização
+ * @param acmrAfter Se não for nulo, recebe o ACMR depois da otimização
+ */
+void optimizeMesh(Mesh& mesh, float* acmrBefore = nullptr, float* acmrAfter = nullptr);
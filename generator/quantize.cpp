@@ -0,0 +1,198 @@
+#include "quantize.h"
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+/// Tamanho do cabeçalho: identificador, contagens e AABB
+const size_t QUANTIZED_HEADER_SIZE = 4 + 2 * sizeof(uint32_t) + 6 * sizeof(float);
+/// Valor máximo de uma coordenada quantizada
+const float QUANTIZED_MAX = 65535.0f;
+
+
+bool isQuantizedMesh(const unsigned char* data, size_t size) {
+    return size >= 4 && memcmp(data, QUANTIZED_MAGIC, 4) == 0;
+}
+
+// Os valores são escritos na ordem de bytes da máquina (little-endian em x86/ARM)
+template <typename T>
+static void put(vector<unsigned char>& out, T value) {
+    unsigned char bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static T get(const unsigned char* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+vector<unsigned char> encodeQuantizedMesh(const Mesh& mesh, const float* bounds) {
+    size_t vertexCount = mesh.vertexCount();
+
+    // AABB indicada ou, por omissão, a AABB da malha
+    float minimum[3] = {0, 0, 0}, maximum[3] = {0, 0, 0};
+    for (int k = 0; bounds && k < 3; k++) {
+        minimum[k] = bounds[k];
+        maximum[k] = bounds[3 + k];
+    }
+    for (size_t v = 0; !bounds && v < vertexCount; v++) {
+        for (int k = 0; k < 3; k++) {
+            float value = mesh.vertices[3 * v + k];
+            if (v == 0 || value < minimum[k]) minimum[k] = value;
+            if (v == 0 || value > maximum[k]) maximum[k] = value;
+        }
+    }
+
+    vector<unsigned char> out;
+    out.reserve(QUANTIZED_HEADER_SIZE + 6 * vertexCount + 1 + 4 * mesh.indices.size());
+    for (char c : QUANTIZED_MAGIC) {
+        out.push_back((unsigned char)c);
+    }
+    put<uint32_t>(out, (uint32_t)vertexCount);
+    put<uint32_t>(out, (uint32_t)mesh.indices.size());
+    for (int k = 0; k < 3; k++) put<float>(out, minimum[k]);
+    for (int k = 0; k < 3; k++) put<float>(out, maximum[k]);
+
+    // Posições: 16 bits por coordenada relativos à AABB
+    for (size_t v = 0; v < vertexCount; v++) {
+        for (int k = 0; k < 3; k++) {
+            float extent = maximum[k] - minimum[k];
+            float t = extent > 0 ? (mesh.vertices[3 * v + k] - minimum[k]) / extent : 0;
+            put<uint16_t>(out, (uint16_t)lround(min(max(t, 0.0f), 1.0f) * QUANTIZED_MAX));
+        }
+    }
+
+    // Índices: diferença ao anterior em zigzag, empacotada com largura fixa
+    vector<uint64_t> deltas(mesh.indices.size());
+    int64_t previous = 0;
+    uint64_t largest = 0;
+    for (size_t i = 0; i < mesh.indices.size(); i++) {
+        int64_t delta = (int64_t)mesh.indices[i] - previous;
+        previous = mesh.indices[i];
+        deltas[i] = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+        largest = max(largest, deltas[i]);
+    }
+
+    int bits = 1;
+    while (bits < 64 && (largest >> bits) != 0) {
+        bits++;
+    }
+    out.push_back((unsigned char)bits);
+
+    uint64_t buffer = 0;
+    int buffered = 0;
+    for (uint64_t delta : deltas) {
+        buffer |= delta << buffered;
+        buffered += bits;
+        while (buffered >= 8) {
+            out.push_back((unsigned char)(buffer & 0xff));
+            buffer >>= 8;
+            buffered -= 8;
+        }
+    }
+    if (buffered > 0) {
+        out.push_back((unsigned char)(buffer & 0xff));
+    }
+
+    return out;
+}
+
+// Converte count valores uint16 intercalados (x, y, z, x, ...) para float
+static void decodePositions(const unsigned char* data, size_t count,
+                            const float* scale, const float* offset, float* out) {
+    size_t i = 0;
+
+#ifdef __SSE2__
+    // 4 vértices (12 valores) por iteração; o padrão x, y, z repete-se a cada 3 registos
+    __m128 s0 = _mm_setr_ps(scale[0], scale[1], scale[2], scale[0]);
+    __m128 s1 = _mm_setr_ps(scale[1], scale[2], scale[0], scale[1]);
+    __m128 s2 = _mm_setr_ps(scale[2], scale[0], scale[1], scale[2]);
+    __m128 o0 = _mm_setr_ps(offset[0], offset[1], offset[2], offset[0]);
+    __m128 o1 = _mm_setr_ps(offset[1], offset[2], offset[0], offset[1]);
+    __m128 o2 = _mm_setr_ps(offset[2], offset[0], offset[1], offset[2]);
+    __m128i zero = _mm_setzero_si128();
+
+    for (; i + 12 <= count; i += 12) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(data + 2 * i));
+        __m128i b = _mm_loadl_epi64((const __m128i*)(data + 2 * i + 16));
+
+        __m128 f0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(a, zero));
+        __m128 f1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(a, zero));
+        __m128 f2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(b, zero));
+
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(f0, s0), o0));
+        _mm_storeu_ps(out + i + 4, _mm_add_ps(_mm_mul_ps(f1, s1), o1));
+        _mm_storeu_ps(out + i + 8, _mm_add_ps(_mm_mul_ps(f2, s2), o2));
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = get<uint16_t>(data + 2 * i) * scale[i % 3] + offset[i % 3];
+    }
+}
+
+bool decodeQuantizedMesh(const unsigned char* data, size_t size, Mesh& mesh) {
+    if (size < QUANTIZED_HEADER_SIZE || !isQuantizedMesh(data, size)) {
+        return false;
+    }
+
+    size_t vertexCount = get<uint32_t>(data + 4);
+    size_t indexCount = get<uint32_t>(data + 8);
+
+    float minimum[3], scale[3];
+    for (int k = 0; k < 3; k++) {
+        minimum[k] = get<float>(data + 12 + 4 * k);
+        float maximum = get<float>(data + 24 + 4 * k);
+        scale[k] = (maximum - minimum[k]) / QUANTIZED_MAX;
+    }
+
+    size_t positionsOffset = QUANTIZED_HEADER_SIZE;
+    size_t indicesOffset = positionsOffset + 6 * vertexCount;
+    if (indicesOffset + 1 > size || indexCount % 3 != 0) {
+        return false;
+    }
+
+    int bits = data[indicesOffset];
+    const unsigned char* packed = data + indicesOffset + 1;
+    size_t packedSize = size - indicesOffset - 1;
+    if (bits < 1 || bits > 57 || (indexCount * bits + 7) / 8 > packedSize) {
+        return false;
+    }
+
+    mesh.vertices.resize(3 * vertexCount);
+    decodePositions(data + positionsOffset, 3 * vertexCount, scale, minimum, mesh.vertices.data());
+
+    mesh.indices.resize(indexCount);
+    uint64_t mask = (bits == 64) ? ~0ULL : ((1ULL << bits) - 1);
+    uint64_t buffer = 0;
+    int buffered = 0;
+    size_t byte = 0;
+    int64_t previous = 0;
+
+    for (size_t i = 0; i < indexCount; i++) {
+        while (buffered < bits) {
+            buffer |= (uint64_t)packed[byte++] << buffered;
+            buffered += 8;
+        }
+        uint64_t zigzag = buffer & mask;
+        buffer >>= bits;
+        buffered -= bits;
+
+        int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+        previous += delta;
+        if (previous < 0 || (size_t)previous >= vertexCount) {
+            return false;
+        }
+        mesh.indices[i] = (unsigned int)previous;
+    }
+
+    return true;
+}
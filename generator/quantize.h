@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "figures.h"
+
+/// Identificador no início de um ficheiro .3d quantizado
+const char QUANTIZED_MAGIC[4] = {'3', 'D', 'Q', '1'};
+
+/**
+ * @brief Codifica uma malha no formato binário quantizado.
+ *
+ * Estrutura (little-endian):
+ * - "3DQ1", número de vértices e número de índices (uint32)
+ * - AABB da malha: mínimo e máximo (6 floats)
+ * - posições: 3 x uint16 por vértice, relativas à AABB
+ * - largura em bits dos índices (uint8) seguida dos índices codificados
+ *   como diferença ao índice anterior (zigzag) e empacotados a essa largura
+ *
+ * Os índices ficam mais pequenos se a malha tiver passado por
+ * optimizeMesh(), que numera os vértices pela ordem de uso.
+ *
+ * @param mesh Malha a codificar
+ * @param bounds AABB de quantização (mínimo x, y, z seguido do máximo x, y, z).
+ *               Se for nulo usa a AABB da malha. Malhas que partilham vértices
+ *               (ex.: blocos de terreno) devem usar a mesma AABB para que os
+ *               vértices partilhados sejam descodificados com o mesmo valor.
+ * @return Bytes do ficheiro
+ */
+std::vector<unsigned char> encodeQuantizedMesh(const Mesh& mesh, const float* bounds = nullptr);
+
+/**
+ * @brief Descodifica uma malha no formato binário quantizado.
+ *
+ * As posições são convertidas para float com SSE2 quando disponível.
+ *
+ * @param data Bytes do ficheiro
+ * @param size Tamanho em bytes
+ * @param mesh Malha que será preenchida
+ *
+ * @return true se os dados são válidos, false caso contrário
+ */
+bool decodeQuantizedMesh(const unsigned char* data, size_t size, Mesh& mesh);
+
+/**
+ * @brief Verifica se um bloco de dados começa com o identificador "3DQ1".
+ */
+bool isQuantizedMesh(const unsigned char* data, size_t size);
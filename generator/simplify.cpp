@@ -0,0 +1,432 @@
+#include "simplify.h"
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <queue>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+/// Peso dos planos de restrição das arestas de fronteira
+const double BOUNDARY_WEIGHT = 1000.0;
+/// Determinante mínimo para resolver a posição ótima do colapso
+const double MIN_DETERMINANT = 1e-12;
+
+
+/**
+ * @struct Quadric
+ * @brief Matriz simétrica 4x4 da soma dos quadrados das distâncias a planos.
+ */
+struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0;
+    double b2 = 0, bc = 0, bd = 0;
+    double c2 = 0, cd = 0;
+    double d2 = 0;
+
+    // Acrescenta o plano ax + by + cz + d = 0 com o peso dado
+    void addPlane(double a, double b, double c, double d, double weight) {
+        a2 += weight * a * a; ab += weight * a * b; ac += weight * a * c; ad += weight * a * d;
+        b2 += weight * b * b; bc += weight * b * c; bd += weight * b * d;
+        c2 += weight * c * c; cd += weight * c * d;
+        d2 += weight * d * d;
+    }
+
+    void add(const Quadric& q) {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+    }
+
+    double error(double x, double y, double z) const {
+        return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+             + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+             + c2 * z * z + 2 * cd * z
+             + d2;
+    }
+};
+
+/**
+ * @struct Collapse
+ * @brief Entrada da fila de prioridade: colapso da aresta (a, b) para (x, y, z).
+ *
+ * As versões dos vértices invalidam entradas antigas sem as remover da fila.
+ */
+struct Collapse {
+    double cost;
+    unsigned int a, b;
+    unsigned int versionA, versionB;
+    double x, y, z;
+
+    bool operator>(const Collapse& other) const { return cost > other.cost; }
+};
+
+/**
+ * @class Simplifier
+ * @brief Estado do colapso de arestas: posições, quádricas e adjacência vértice-triângulo.
+ */
+class Simplifier {
+public:
+    explicit Simplifier(const Mesh& mesh);
+
+    Mesh run(size_t targetTriangles, double maxError, double* finalError);
+
+private:
+    vector<double> positions;               // x, y, z por vértice
+    vector<unsigned int> triangles;         // 3 índices por triângulo
+    vector<bool> triangleAlive;
+    vector<bool> vertexAlive;
+    vector<bool> seam;                      // vértice com a mesma posição que outro (costura)
+    vector<unsigned int> versions;
+    vector<Quadric> quadrics;
+    vector<vector<unsigned int>> adjacency; // triângulos de cada vértice
+    priority_queue<Collapse, vector<Collapse>, greater<Collapse>> queue;
+    size_t liveTriangles;
+
+    void computeQuadrics();
+    void pushEdge(unsigned int a, unsigned int b);
+    bool isValid(const Collapse& collapse);
+    void collapse(const Collapse& collapse);
+    void neighbours(unsigned int v, vector<unsigned int>& out);
+    void faceNormal(unsigned int t, unsigned int moved, const double* to, double* normal);
+};
+
+Simplifier::Simplifier(const Mesh& mesh) {
+    size_t vertexCount = mesh.vertexCount();
+    positions.assign(mesh.vertices.begin(), mesh.vertices.end());
+    triangles = mesh.indices;
+    triangleAlive.assign(mesh.triangleCount(), true);
+    vertexAlive.assign(vertexCount, true);
+    versions.assign(vertexCount, 0);
+    quadrics.assign(vertexCount, Quadric());
+    adjacency.assign(vertexCount, vector<unsigned int>());
+    liveTriangles = mesh.triangleCount();
+
+    // Costuras: vértices distintos na mesma posição
+    map<tuple<float, float, float>, unsigned int> positionUse;
+    for (size_t v = 0; v < vertexCount; v++) {
+        positionUse[make_tuple(mesh.vertices[3 * v], mesh.vertices[3 * v + 1], mesh.vertices[3 * v + 2])]++;
+    }
+    seam.assign(vertexCount, false);
+    for (size_t v = 0; v < vertexCount; v++) {
+        seam[v] = positionUse[make_tuple(mesh.vertices[3 * v], mesh.vertices[3 * v + 1], mesh.vertices[3 * v + 2])] > 1;
+    }
+
+    for (size_t t = 0; t < mesh.triangleCount(); t++) {
+        for (int k = 0; k < 3; k++) {
+            adjacency[triangles[3 * t + k]].push_back((unsigned int)t);
+        }
+    }
+
+    computeQuadrics();
+
+    // Uma entrada por aresta
+    for (unsigned int v = 0; v < vertexCount; v++) {
+        vector<unsigned int> around;
+        neighbours(v, around);
+        for (unsigned int n : around) {
+            if (v < n) {
+                pushEdge(v, n);
+            }
+        }
+    }
+}
+
+void Simplifier::computeQuadrics() {
+    // Contagem de uso de cada aresta para identificar as fronteiras
+    map<pair<unsigned int, unsigned int>, int> edgeUse;
+    for (size_t t = 0; t < triangleAlive.size(); t++) {
+        for (int k = 0; k < 3; k++) {
+            unsigned int a = triangles[3 * t + k], b = triangles[3 * t + (k + 1) % 3];
+            edgeUse[minmax(a, b)]++;
+        }
+    }
+
+    for (size_t t = 0; t < triangleAlive.size(); t++) {
+        const unsigned int* tri = &triangles[3 * t];
+        const double* p0 = &positions[3 * tri[0]];
+        const double* p1 = &positions[3 * tri[1]];
+        const double* p2 = &positions[3 * tri[2]];
+
+        double u[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+        double w[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+        double n[3] = {u[1] * w[2] - u[2] * w[1], u[2] * w[0] - u[0] * w[2], u[0] * w[1] - u[1] * w[0]};
+        double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length == 0) {
+            continue;
+        }
+        n[0] /= length; n[1] /= length; n[2] /= length;
+
+        // Plano da face, com peso proporcional à área
+        double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+        double area = length / 2;
+        for (int k = 0; k < 3; k++) {
+            quadrics[tri[k]].addPlane(n[0], n[1], n[2], d, area);
+        }
+
+        // Arestas de fronteira: plano perpendicular à face que contém a aresta
+        for (int k = 0; k < 3; k++) {
+            unsigned int a = tri[k], b = tri[(k + 1) % 3];
+            if (edgeUse[minmax(a, b)] != 1) {
+                continue;
+            }
+
+            const double* pa = &positions[3 * a];
+            const double* pb = &positions[3 * b];
+            double e[3] = {pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2]};
+            double c[3] = {e[1] * n[2] - e[2] * n[1], e[2] * n[0] - e[0] * n[2], e[0] * n[1] - e[1] * n[0]};
+            double edgeLength2 = e[0] * e[0] + e[1] * e[1] + e[2] * e[2];
+            double cLength = sqrt(c[0] * c[0] + c[1] * c[1] + c[2] * c[2]);
+            if (cLength == 0) {
+                continue;
+            }
+            c[0] /= cLength; c[1] /= cLength; c[2] /= cLength;
+
+            double cd = -(c[0] * pa[0] + c[1] * pa[1] + c[2] * pa[2]);
+            quadrics[a].addPlane(c[0], c[1], c[2], cd, BOUNDARY_WEIGHT * edgeLength2);
+            quadrics[b].addPlane(c[0], c[1], c[2], cd, BOUNDARY_WEIGHT * edgeLength2);
+        }
+    }
+}
+
+void Simplifier::neighbours(unsigned int v, vector<unsigned int>& out) {
+    out.clear();
+    for (unsigned int t : adjacency[v]) {
+        if (!triangleAlive[t]) {
+            continue;
+        }
+        for (int k = 0; k < 3; k++) {
+            unsigned int n = triangles[3 * t + k];
+            if (n != v && find(out.begin(), out.end(), n) == out.end()) {
+                out.push_back(n);
+            }
+        }
+    }
+}
+
+void Simplifier::pushEdge(unsigned int a, unsigned int b) {
+    // Os vértices de costura não se movem: só recebem vizinhos, na sua posição.
+    // Duas cópias de uma costura que se movessem de forma diferente abririam uma fenda.
+    if (seam[a] && seam[b]) {
+        return;
+    }
+    if (seam[b]) {
+        swap(a, b);
+    }
+
+    Quadric q = quadrics[a];
+    q.add(quadrics[b]);
+
+    Collapse c;
+    c.a = a;
+    c.b = b;
+    c.versionA = versions[a];
+    c.versionB = versions[b];
+
+    // Posição ótima: resolve o sistema 3x3 da quádrica pela regra de Cramer
+    double det = q.a2 * (q.b2 * q.c2 - q.bc * q.bc)
+               - q.ab * (q.ab * q.c2 - q.bc * q.ac)
+               + q.ac * (q.ab * q.bc - q.b2 * q.ac);
+
+    if (seam[a]) {
+        c.x = positions[3 * a];
+        c.y = positions[3 * a + 1];
+        c.z = positions[3 * a + 2];
+        c.cost = q.error(c.x, c.y, c.z);
+    } else if (fabs(det) > MIN_DETERMINANT) {
+        c.x = -(q.ad * (q.b2 * q.c2 - q.bc * q.bc) - q.ab * (q.bd * q.c2 - q.bc * q.cd) + q.ac * (q.bd * q.bc - q.b2 * q.cd)) / det;
+        c.y = -(q.a2 * (q.bd * q.c2 - q.cd * q.bc) - q.ad * (q.ab * q.c2 - q.bc * q.ac) + q.ac * (q.ab * q.cd - q.bd * q.ac)) / det;
+        c.z = -(q.a2 * (q.b2 * q.cd - q.bc * q.bd) - q.ab * (q.ab * q.cd - q.bd * q.ac) + q.ad * (q.ab * q.bc - q.b2 * q.ac)) / det;
+        c.cost = q.error(c.x, c.y, c.z);
+    } else {
+        // Sistema singular: escolhe a melhor entre as extremidades e o ponto médio
+        const double* pa = &positions[3 * a];
+        const double* pb = &positions[3 * b];
+        double candidates[3][3] = {
+            {pa[0], pa[1], pa[2]},
+            {pb[0], pb[1], pb[2]},
+            {(pa[0] + pb[0]) / 2, (pa[1] + pb[1]) / 2, (pa[2] + pb[2]) / 2}
+        };
+
+        c.cost = -1;
+        for (const double* p : candidates) {
+            double cost = q.error(p[0], p[1], p[2]);
+            if (c.cost < 0 || cost < c.cost) {
+                c.cost = cost;
+                c.x = p[0]; c.y = p[1]; c.z = p[2];
+            }
+        }
+    }
+
+    // Erros negativos resultam apenas de arredondamento
+    c.cost = max(c.cost, 0.0);
+    queue.push(c);
+}
+
+// Normal do triângulo t com o vértice moved deslocado para to
+void Simplifier::faceNormal(unsigned int t, unsigned int moved, const double* to, double* normal) {
+    const double* p[3];
+    for (int k = 0; k < 3; k++) {
+        unsigned int v = triangles[3 * t + k];
+        p[k] = v == moved ? to : &positions[3 * v];
+    }
+
+    double u[3] = {p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2]};
+    double w[3] = {p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2]};
+    normal[0] = u[1] * w[2] - u[2] * w[1];
+    normal[1] = u[2] * w[0] - u[0] * w[2];
+    normal[2] = u[0] * w[1] - u[1] * w[0];
+}
+
+bool Simplifier::isValid(const Collapse& c) {
+    // Condição de ligação: os vizinhos comuns têm de ser os vértices opostos
+    // dos triângulos que partilham a aresta, senão o colapso cria uma aresta não-manifold
+    vector<unsigned int> aroundA, aroundB;
+    neighbours(c.a, aroundA);
+    neighbours(c.b, aroundB);
+
+    int common = 0;
+    for (unsigned int n : aroundA) {
+        if (find(aroundB.begin(), aroundB.end(), n) != aroundB.end()) {
+            common++;
+        }
+    }
+
+    int shared = 0;
+    for (unsigned int t : adjacency[c.a]) {
+        if (!triangleAlive[t]) {
+            continue;
+        }
+        const unsigned int* tri = &triangles[3 * t];
+        if (tri[0] == c.b || tri[1] == c.b || tri[2] == c.b) {
+            shared++;
+        }
+    }
+    if (shared == 0 || common > shared) {
+        return false;
+    }
+
+    // Nenhum triângulo que sobrevive pode inverter ou degenerar
+    double target[3] = {c.x, c.y, c.z};
+    for (unsigned int v : {c.a, c.b}) {
+        for (unsigned int t : adjacency[v]) {
+            if (!triangleAlive[t]) {
+                continue;
+            }
+            const unsigned int* tri = &triangles[3 * t];
+            unsigned int other = v == c.a ? c.b : c.a;
+            if (tri[0] == other || tri[1] == other || tri[2] == other) {
+                continue;
+            }
+
+            double before[3], after[3];
+            faceNormal(t, v, &positions[3 * v], before);
+            faceNormal(t, v, target, after);
+
+            double dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+            double lengthBefore = sqrt(before[0] * before[0] + before[1] * before[1] + before[2] * before[2]);
+            double lengthAfter = sqrt(after[0] * after[0] + after[1] * after[1] + after[2] * after[2]);
+            if (lengthAfter <= 1e-12 * lengthBefore || dot <= 0.2 * lengthBefore * lengthAfter) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void Simplifier::collapse(const Collapse& c) {
+    positions[3 * c.a] = c.x;
+    positions[3 * c.a + 1] = c.y;
+    positions[3 * c.a + 2] = c.z;
+    quadrics[c.a].add(quadrics[c.b]);
+    vertexAlive[c.b] = false;
+    versions[c.a]++;
+
+    // Triângulos com a aresta desaparecem; os restantes passam de b para a
+    for (unsigned int t : adjacency[c.b]) {
+        if (!triangleAlive[t]) {
+            continue;
+        }
+        unsigned int* tri = &triangles[3 * t];
+        if (tri[0] == c.a || tri[1] == c.a || tri[2] == c.a) {
+            triangleAlive[t] = false;
+            liveTriangles--;
+        } else {
+            for (int k = 0; k < 3; k++) {
+                if (tri[k] == c.b) {
+                    tri[k] = c.a;
+                }
+            }
+            adjacency[c.a].push_back(t);
+        }
+    }
+    adjacency[c.b].clear();
+
+    // Remove triângulos mortos da lista de a
+    vector<unsigned int>& list = adjacency[c.a];
+    list.erase(remove_if(list.begin(), list.end(),
+                         [this](unsigned int t) { return !triangleAlive[t]; }), list.end());
+
+    vector<unsigned int> around;
+    neighbours(c.a, around);
+    for (unsigned int n : around) {
+        pushEdge(c.a, n);
+    }
+}
+
+Mesh Simplifier::run(size_t targetTriangles, double maxError, double* finalError) {
+    double largest = 0;
+
+    while (liveTriangles > targetTriangles && !queue.empty()) {
+        Collapse c = queue.top();
+        queue.pop();
+
+        // Entradas antigas: algum vértice já morreu ou foi movido
+        if (!vertexAlive[c.a] || !vertexAlive[c.b] ||
+            versions[c.a] != c.versionA || versions[c.b] != c.versionB) {
+            continue;
+        }
+        if (maxError >= 0 && c.cost > maxError) {
+            break;
+        }
+        if (!isValid(c)) {
+            continue;
+        }
+
+        collapse(c);
+        largest = max(largest, c.cost);
+    }
+
+    if (finalError) {
+        *finalError = largest;
+    }
+
+    // Compacta vértices e triângulos vivos
+    Mesh result;
+    vector<unsigned int> remap(vertexAlive.size(), ~0u);
+    for (size_t t = 0; t < triangleAlive.size(); t++) {
+        if (!triangleAlive[t]) {
+            continue;
+        }
+        unsigned int out[3];
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = triangles[3 * t + k];
+            if (remap[v] == ~0u) {
+                remap[v] = result.addVertex((float)positions[3 * v], (float)positions[3 * v + 1],
+                                            (float)positions[3 * v + 2]);
+            }
+            out[k] = remap[v];
+        }
+        result.addTriangle(out[0], out[1], out[2]);
+    }
+
+    return result;
+}
+
+Mesh simplifyMesh(const Mesh& mesh, size_t targetTriangles, double maxError, double* finalError) {
+    Simplifier simplifier(mesh);
+    return simplifier.run(targetTriangles, maxError, finalError);
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include "figures.h"
+
+/**
+ * @brief Simplifica uma malha por colapso de arestas com métrica de erro quádrica.
+ *
+ * Implementa o algoritmo de Garland e Heckbert: cada vértice acumula a quádrica
+ * dos planos das suas faces e as arestas são colapsadas por ordem crescente de
+ * erro, usando uma fila de prioridade. Cada colapso coloca o vértice resultante
+ * na posição que minimiza a soma das quádricas.
+ *
+ * Arestas de fronteira (usadas por um só triângulo) recebem planos de restrição
+ * perpendiculares, que mantêm os contornos. Os vértices de costura (vértices
+ * distintos com a mesma posição, ex.: a costura da esfera numa malha indexada)
+ * ficam fixos: só outros vértices colapsam para eles, pelo que os dois lados
+ * da costura continuam a coincidir. Colapsos que invertam triângulos ou criem
+ * geometria não-manifold são rejeitados.
+ *
+ * @param mesh Malha indexada de entrada
+ * @param targetTriangles Número de triângulos a atingir
+ * @param maxError Erro quádrico máximo por colapso (negativo para ignorar)
+ * @param finalError Se não for nulo, recebe o maior erro de um colapso efetuado
+ *
+ * @return Malha simplificada, com os vértices não usados removidos
+ */
+Mesh simplifyMesh(const Mesh& mesh, size_t targetTriangles, double maxError = -1, double* finalError = nullptr);
@@ -0,0 +1,295 @@
+#include "terrain.h"
+#include "quantize.h"
+#include "optimizer.h"
+#include "log.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+using namespace std;
+
+/// Número de oitavas do ruído fBm
+const int NOISE_OCTAVES = 5;
+/// Frequência da primeira oitava (ciclos ao longo do terreno)
+const float NOISE_BASE_FREQUENCY = 4.0f;
+/// Tamanho de cada entrada da tabela de blocos: posição, tamanho e AABB
+const uint64_t CHUNK_ENTRY_SIZE = 2 * sizeof(uint64_t) + 6 * sizeof(float);
+
+
+/**
+ * @struct Heightmap
+ * @brief Imagem de alturas em escala de cinzentos, normalizada para [0, 1].
+ */
+struct Heightmap {
+    int width = 0, height = 0;
+    vector<float> values;
+
+    // Amostragem bilinear com u, v em [0, 1]
+    float sample(float u, float v) const {
+        float x = min(max(u, 0.0f), 1.0f) * (width - 1);
+        float y = min(max(v, 0.0f), 1.0f) * (height - 1);
+        int x0 = (int)x, y0 = (int)y;
+        int x1 = min(x0 + 1, width - 1), y1 = min(y0 + 1, height - 1);
+        float fx = x - x0, fy = y - y0;
+
+        float top = values[y0 * width + x0] * (1 - fx) + values[y0 * width + x1] * fx;
+        float bottom = values[y1 * width + x0] * (1 - fx) + values[y1 * width + x1] * fx;
+        return top * (1 - fy) + bottom * fy;
+    }
+};
+
+// Lê o próximo número do cabeçalho PGM, saltando comentários
+static bool readPgmNumber(istream& in, int& value) {
+    in >> ws;
+    while (in.peek() == '#') {
+        string comment;
+        getline(in, comment);
+        in >> ws;
+    }
+    return (bool)(in >> value);
+}
+
+// Lê uma imagem PGM (P2 em texto ou P5 binário, 8 ou 16 bits)
+static bool loadHeightmap(const string& path, Heightmap& map) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        LogLine(cerr) << "Erro ao abrir a heightmap: " << path;
+        return false;
+    }
+
+    string magic;
+    file >> magic;
+    int maxValue;
+    if ((magic != "P2" && magic != "P5") || !readPgmNumber(file, map.width) ||
+        !readPgmNumber(file, map.height) || !readPgmNumber(file, maxValue) ||
+        map.width < 1 || map.height < 1 || maxValue < 1 || maxValue > 65535) {
+        LogLine(cerr) << "Heightmap inválida (só PGM P2/P5 é suportado): " << path;
+        return false;
+    }
+
+    size_t count = (size_t)map.width * map.height;
+    map.values.resize(count);
+
+    if (magic == "P2") {
+        for (size_t i = 0; i < count; i++) {
+            int value;
+            if (!(file >> value)) {
+                return false;
+            }
+            map.values[i] = (float)value / maxValue;
+        }
+        return true;
+    }
+
+    // P5: um único espaço separa o cabeçalho dos dados
+    file.get();
+    int bytesPerValue = maxValue > 255 ? 2 : 1;
+    vector<unsigned char> data(count * bytesPerValue);
+    if (!file.read((char*)data.data(), data.size())) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        int value = bytesPerValue == 2 ? (data[2 * i] << 8) | data[2 * i + 1] : data[i];
+        map.values[i] = (float)value / maxValue;
+    }
+    return true;
+}
+
+// Valor pseudo-aleatório em [0, 1] num ponto inteiro da grelha
+static float latticeValue(int x, int z, unsigned int seed) {
+    unsigned int h = seed * 374761393u + (unsigned int)x * 668265263u + (unsigned int)z * 2147483647u;
+    h = (h ^ (h >> 13)) * 1274126177u;
+    h ^= h >> 16;
+    return (h & 0xffffff) / (float)0xffffff;
+}
+
+static float valueNoise(float x, float z, unsigned int seed) {
+    int x0 = (int)floor(x), z0 = (int)floor(z);
+    float fx = x - x0, fz = z - z0;
+
+    // Interpolação suave (smoothstep) entre os 4 cantos
+    fx = fx * fx * (3 - 2 * fx);
+    fz = fz * fz * (3 - 2 * fz);
+
+    float a = latticeValue(x0, z0, seed), b = latticeValue(x0 + 1, z0, seed);
+    float c = latticeValue(x0, z0 + 1, seed), d = latticeValue(x0 + 1, z0 + 1, seed);
+    return (a * (1 - fx) + b * fx) * (1 - fz) + (c * (1 - fx) + d * fx) * fz;
+}
+
+// Ruído fBm em [0, 1] com u, v em [0, 1]
+static float fbm(float u, float v, unsigned int seed) {
+    float sum = 0, amplitude = 0.5f, total = 0, frequency = NOISE_BASE_FREQUENCY;
+    for (int octave = 0; octave < NOISE_OCTAVES; octave++) {
+        sum += amplitude * valueNoise(u * frequency, v * frequency, seed + octave);
+        total += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2;
+    }
+    return sum / total;
+}
+
+template <typename T>
+static void writeValue(ofstream& file, T value) {
+    file.write((const char*)&value, sizeof(T));
+}
+
+bool generateTerrain(const string& path, const TerrainParams& params, size_t* chunkCount) {
+    if (params.divisions < 1 || params.chunkDivisions < 1) {
+        LogLine(cerr) << "Parâmetros de terreno inválidos";
+        return false;
+    }
+
+    Heightmap heightmap;
+    if (!params.heightmap.empty() && !loadHeightmap(params.heightmap, heightmap)) {
+        return false;
+    }
+
+    ofstream file(path, ios::binary);
+    if (!file.is_open()) {
+        LogLine(cerr) << "Erro ao abrir o ficheiro: " << path;
+        return false;
+    }
+
+    // Cabeçalho provisório; a tabela só é conhecida no fim
+    int chunksPerSide = (params.divisions + params.chunkDivisions - 1) / params.chunkDivisions;
+    file.write(CHUNKED_MAGIC, 4);
+    writeValue<uint32_t>(file, (uint32_t)chunksPerSide * chunksPerSide);
+    writeValue<uint64_t>(file, 0);
+
+    float step = params.size / params.divisions;
+    float start = -params.size / 2;
+    vector<ChunkInfo> table;
+
+    // Todos os blocos são quantizados na AABB do terreno, para não haver fendas
+    float bounds[6] = {start, min(0.0f, params.height), start,
+                       -start, max(0.0f, params.height), -start};
+
+    for (int cz = 0; cz < chunksPerSide; cz++) {
+        for (int cx = 0; cx < chunksPerSide; cx++) {
+            int firstI = cz * params.chunkDivisions, firstJ = cx * params.chunkDivisions;
+            int rows = min(params.chunkDivisions, params.divisions - firstI);
+            int cols = min(params.chunkDivisions, params.divisions - firstJ);
+
+            // Os vértices da fronteira são calculados a partir das coordenadas globais
+            // da grelha, pelo que blocos vizinhos coincidem exatamente
+            Mesh mesh;
+            for (int i = 0; i <= rows; i++) {
+                for (int j = 0; j <= cols; j++) {
+                    int gi = firstI + i, gj = firstJ + j;
+                    float u = (float)gj / params.divisions, v = (float)gi / params.divisions;
+                    float h = heightmap.values.empty() ? fbm(u, v, params.seed) : heightmap.sample(u, v);
+                    mesh.addVertex(start + gj * step, params.height * h, start + gi * step);
+                }
+            }
+
+            int row = cols + 1;
+            for (int i = 0; i < rows; i++) {
+                for (int j = 0; j < cols; j++) {
+                    unsigned int p1 = i * row + j;
+                    unsigned int p2 = i * row + j + 1;
+                    unsigned int p3 = (i + 1) * row + j;
+                    unsigned int p4 = (i + 1) * row + j + 1;
+
+                    mesh.addTriangle(p1, p3, p2);
+                    mesh.addTriangle(p2, p3, p4);
+                }
+            }
+
+            if (params.optimize) {
+                optimizeMesh(mesh);
+            }
+
+            ChunkInfo info;
+            info.offset = (uint64_t)file.tellp();
+            for (int k = 0; k < 3; k++) {
+                info.min[k] = info.max[k] = mesh.vertices[k];
+            }
+            for (size_t v = 0; v < mesh.vertices.size(); v += 3) {
+                for (int k = 0; k < 3; k++) {
+                    info.min[k] = min(info.min[k], mesh.vertices[v + k]);
+                    info.max[k] = max(info.max[k], mesh.vertices[v + k]);
+                }
+            }
+
+            vector<unsigned char> data = encodeQuantizedMesh(mesh, bounds);
+            file.write((const char*)data.data(), data.size());
+            info.size = data.size();
+            table.push_back(info);
+        }
+    }
+
+    uint64_t tableOffset = (uint64_t)file.tellp();
+    for (const ChunkInfo& info : table) {
+        writeValue<uint64_t>(file, info.offset);
+        writeValue<uint64_t>(file, info.size);
+        for (int k = 0; k < 3; k++) writeValue<float>(file, info.min[k]);
+        for (int k = 0; k < 3; k++) writeValue<float>(file, info.max[k]);
+    }
+
+    file.seekp(4 + sizeof(uint32_t));
+    writeValue<uint64_t>(file, tableOffset);
+
+    if (chunkCount) {
+        *chunkCount = table.size();
+    }
+    return (bool)file;
+}
+
+bool readChunkTable(const string& path, vector<ChunkInfo>& table) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[4];
+    uint32_t count;
+    uint64_t tableOffset;
+    if (!file.read(magic, 4) || memcmp(magic, CHUNKED_MAGIC, 4) != 0 ||
+        !file.read((char*)&count, sizeof(count)) || !file.read((char*)&tableOffset, sizeof(tableOffset))) {
+        return false;
+    }
+
+    // A tabela e os blocos têm de caber no ficheiro: o cabeçalho não é de confiança
+    file.seekg(0, ios::end);
+    uint64_t fileSize = (uint64_t)file.tellg();
+    if (tableOffset > fileSize || count > (fileSize - tableOffset) / CHUNK_ENTRY_SIZE) {
+        return false;
+    }
+
+    file.seekg(tableOffset);
+    table.resize(count);
+    for (ChunkInfo& info : table) {
+        if (!file.read((char*)&info.offset, sizeof(info.offset)) ||
+            !file.read((char*)&info.size, sizeof(info.size)) ||
+            !file.read((char*)info.min, sizeof(info.min)) ||
+            !file.read((char*)info.max, sizeof(info.max)) ||
+            info.offset > fileSize || info.size > fileSize - info.offset) {
+            table.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool readChunk(const string& path, const ChunkInfo& chunk, Mesh& mesh) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // O ficheiro pode ter mudado desde que a tabela foi lida
+    file.seekg(0, ios::end);
+    uint64_t fileSize = (uint64_t)file.tellg();
+    if (chunk.offset > fileSize || chunk.size > fileSize - chunk.offset) {
+        return false;
+    }
+
+    vector<unsigned char> data(chunk.size);
+    file.seekg(chunk.offset);
+    if (!file.read((char*)data.data(), data.size())) {
+        return false;
+    }
+    return decodeQuantizedMesh(data.data(), data.size(), mesh);
+}
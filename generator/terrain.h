@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "figures.h"
+
+/// Identificador no início de um ficheiro de terreno por blocos
+const char CHUNKED_MAGIC[4] = {'3', 'D', 'C', '1'};
+
+/**
+ * @struct ChunkInfo
+ * @brief Entrada da tabela de blocos: posição no ficheiro e AABB do bloco.
+ */
+struct ChunkInfo {
+    uint64_t offset;  ///< Posição do bloco (malha 3DQ1) no ficheiro
+    uint64_t size;    ///< Tamanho do bloco em bytes
+    float min[3];     ///< Canto mínimo da AABB
+    float max[3];     ///< Canto máximo da AABB
+};
+
+/**
+ * @struct TerrainParams
+ * @brief Parâmetros do terreno gerado por generateTerrain().
+ */
+struct TerrainParams {
+    float size = 1;              ///< Comprimento do lado do terreno (plano XZ)
+    int divisions = 1;           ///< Divisões em cada eixo
+    int chunkDivisions = 64;     ///< Divisões de cada bloco em cada eixo
+    float height = 0;            ///< Altura máxima
+    unsigned int seed = 0;       ///< Semente do ruído (sem heightmap)
+    std::string heightmap;       ///< Imagem PGM de alturas (opcional)
+    bool optimize = false;       ///< Otimiza cada bloco para a cache de vértices
+};
+
+/**
+ * @brief Gera um terreno dividido em blocos e escreve-o em streaming.
+ *
+ * Cada bloco é uma grelha de chunkDivisions^2 células, com altura dada por
+ * ruído fBm ou por uma heightmap PGM, codificada no formato quantizado 3DQ1.
+ * Só um bloco está em memória de cada vez.
+ *
+ * Estrutura do ficheiro:
+ * - "3DC1", número de blocos (uint32), posição da tabela (uint64)
+ * - os blocos, um a seguir ao outro
+ * - a tabela: um ChunkInfo por bloco
+ *
+ * @param path Caminho do ficheiro de saída
+ * @param params Parâmetros do terreno
+ * @param chunkCount Se não for nulo, recebe o número de blocos escritos
+ *
+ * @return true se o ficheiro foi escrito, false caso contrário
+ */
+bool generateTerrain(const std::string& path, const TerrainParams& params, size_t* chunkCount = nullptr);
+
+/**
+ * @brief Lê a tabela de blocos de um ficheiro 3DC1.
+ *
+ * @return false se o ficheiro não existir, não for um terreno por blocos ou se a
+ *         tabela ou algum bloco não couberem no ficheiro
+ */
+bool readChunkTable(const std::string& path, std::vector<ChunkInfo>& table);
+
+/**
+ * @brief Lê e descodifica um único bloco de um ficheiro 3DC1.
+ */
+bool readChunk(const std::string& path, const ChunkInfo& chunk, Mesh& mesh);